@@ -0,0 +1,235 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: the stages of mouse_m908 -c and mouse_m908 -R for every model,
+ * no mouse required. The average time and number of allocations per
+ * iteration of each stage are printed as JSON:
+ * - parse: read the configuration (rd_config::load())
+ * - apply: call the setters of a new object (rd_config::apply())
+ * - encode: prepare the packets without sending them (set_packet_capture())
+ * - write: send the packets (write_packets())
+ * - read: read the settings from the mouse (read_snapshot())
+ * - decode: print the settings (read_and_print_settings())
+ *
+ * Usage: bench_apply [iterations] [latency us] [examples directory]
+ *
+ * The wired mice are emulated (see rd_emulator) with the given latency per
+ * transfer (default 0, only the time spent in this program is measured).
+ * The wireless mice are not emulated, their transfers are acknowledged after
+ * the latency with empty responses; they build the packets while sending, so
+ * write includes encoding and there is no encode stage.
+ *
+ * Each model applies examples/example_m<model>.ini, or the settings printed by
+ * a new object of the model if there is no example.
+ */
+
+#include "../include/rd_mouse.h"
+#include "../include/rd_config.h"
+#include "../include/emulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+// count all allocations
+static size_t allocations = 0;
+
+void* operator new( size_t size ){
+	allocations++;
+	void* pointer = std::malloc( size > 0 ? size : 1 );
+	if( pointer == nullptr )
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete( void* pointer ) noexcept{ std::free( pointer ); }
+void operator delete( void* pointer, size_t ) noexcept{ std::free( pointer ); }
+
+// answers every transfer after the latency, in transfers receive zeros
+class sink_transport : public rd_transport{
+
+	public:
+
+		sink_transport( unsigned int latency ) : _i_latency( latency ) {}
+
+		int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) override{
+			(void)request; (void)value; (void)index; (void)timeout;
+			_i_transfer( request_type, data, length );
+			return length;
+		}
+
+		int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) override{
+			(void)timeout;
+			_i_transfer( endpoint, data, length );
+			if( transferred != NULL )
+				*transferred = length;
+			return 0;
+		}
+
+		bool uses_device() override{ return false; }
+
+	private:
+
+		unsigned int _i_latency;
+
+		void _i_transfer( uint8_t request_type, uint8_t* data, int length ){
+			if( _i_latency > 0 )
+				std::this_thread::sleep_for( std::chrono::microseconds( _i_latency ) );
+			if( (request_type & 0x80) && data != NULL )
+				std::fill( data, data+length, 0 );
+		}
+};
+
+// accumulated time and allocations of a stage
+struct stage{
+	const char* name;
+	double total = 0;
+	size_t allocations = 0;
+	bool used = false;
+};
+
+template< typename F > void measure( stage& s, F&& function ){
+	size_t allocations_before = allocations;
+	auto start = std::chrono::steady_clock::now();
+	function();
+	s.total += std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+	s.allocations += allocations - allocations_before;
+	s.used = true;
+}
+
+int main( int argc, char **argv ){
+
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 20;
+	unsigned int latency = (argc > 2) ? std::stoi( argv[2] ) : 0;
+	std::string examples = (argc > 3) ? argv[3] : "examples";
+
+	int failures = 0;
+
+	std::cout << "{\n";
+	std::cout << "  \"iterations\": " << iterations << ",\n";
+	std::cout << "  \"latency_us\": " << latency << ",\n";
+	std::cout << "  \"models\": [";
+
+	bool first_model = true;
+
+	for( size_t i = 1; i < std::variant_size_v< rd_mouse::mouse_variant >; i++ ){
+
+		rd_mouse::mouse_variant mouse = rd_mouse::model_registry::create( i );
+
+		std::visit( [&](auto& model){
+
+			typedef std::decay_t< decltype(model) > T;
+			if constexpr( !std::is_same_v< T, rd_mouse::monostate > ){
+
+				constexpr bool wireless = std::is_base_of_v< rd_mouse_wireless, T >;
+
+				// configuration
+				std::string path = examples + "/example_" + ( model.get_name() == "generic" ? "" : "m" ) + model.get_name() + ".ini";
+				bool generated = !std::ifstream( path ).is_open();
+				if( generated ){
+					path = "bench_apply_" + model.get_name() + ".ini";
+					std::ofstream out( path );
+					model.print_settings( out );
+				}
+
+				stage stages[] = { {"parse"}, {"apply"}, {"encode"}, {"write"}, {"read"}, {"decode"} };
+				size_t packets = 0, config_errors = 0, failed = 0;
+
+				for( int j = 0; j < iterations; j++ ){
+
+					rd_emulator emulator;
+					emulator.set_latency( latency );
+					sink_transport sink( latency );
+
+					rd_config config;
+					std::vector< std::string > errors;
+					T m;
+					if constexpr( wireless )
+						m.set_transport( &sink );
+					else
+						m.set_transport( &emulator );
+					m.open_mouse();
+
+					measure( stages[0], [&](){ config.load( path, m.lightmode_strings(), m.report_rate_strings(), m.button_names(), errors ); } );
+					measure( stages[1], [&](){ config.apply( m, errors ); } );
+					config_errors = errors.size();
+
+					if constexpr( wireless ){
+						measure( stages[3], [&](){ failed += m.write_changes(); } );
+					} else{
+						std::vector< rd_mouse::rd_packet > capture;
+						measure( stages[2], [&](){
+							m.set_packet_capture( &capture );
+							m.write_changes();
+							m.set_packet_capture( nullptr );
+						} );
+						packets = capture.size();
+						measure( stages[3], [&](){ failed += m.write_packets( capture ); } );
+					}
+
+					rd_mouse::rd_device_snapshot snapshot;
+					measure( stages[4], [&](){ m.read_snapshot( snapshot ); } );
+
+					std::stringstream printed;
+					measure( stages[5], [&](){ m.read_and_print_settings( snapshot, printed ); } );
+
+					m.close_mouse();
+				}
+
+				if( generated )
+					std::remove( path.c_str() );
+
+				failures += failed;
+
+				std::cout << ( first_model ? "\n" : ",\n" ) << "    {\n";
+				std::cout << "      \"model\": \"" << model.get_name() << "\",\n";
+				std::cout << "      \"emulated\": " << ( wireless ? "false" : "true" ) << ",\n";
+				std::cout << "      \"config\": \"" << ( generated ? "generated" : path ) << "\",\n";
+				std::cout << "      \"config_errors\": " << config_errors << ",\n";
+				if constexpr( !wireless )
+					std::cout << "      \"packets\": " << packets << ",\n";
+				std::cout << "      \"failed_packets\": " << failed << ",\n";
+				std::cout << "      \"stages\": {";
+
+				bool first_stage = true;
+				for( auto& s : stages ){
+					if( !s.used )
+						continue;
+					std::cout << ( first_stage ? "\n" : ",\n" )
+						<< "        \"" << s.name << "\": { \"ns\": " << (uint64_t)( s.total / iterations )
+						<< ", \"allocs\": " << (double)s.allocations / iterations << " }";
+					first_stage = false;
+				}
+
+				std::cout << "\n      }\n    }";
+				first_model = false;
+			}
+		}, mouse );
+	}
+
+	std::cout << "\n  ]\n}\n";
+
+	return ( failures == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: time of rd_mouse::_i_encode_button_mapping() for every
+ * button mapping listed in keymap.md, compared to the previous regex
+ * based implementation.
+ *
+ * Usage: bench_button_mapping [keymap.md] [iterations]
+ *
+ * The templates in keymap.md (macro⟨N⟩, fire:⟨button⟩:..., snipe:⟨DPI⟩,
+ * modifiers) are expanded to concrete mappings, some invalid mappings
+ * are added. Both implementations must return the same results,
+ * otherwise the benchmark fails.
+ */
+
+#include "../include/rd_mouse.h"
+
+#include <chrono>
+
+// gives access to the encoding function and the tables of rd_mouse
+class bench_mouse : public rd_mouse{
+
+	public:
+
+		using rd_mouse::_i_encode_button_mapping;
+
+		// the previous implementation of rd_mouse::_i_encode_button_mapping(), as a reference
+		static int regex_encode_button_mapping( const std::string& mapping, std::array<uint8_t, 4>& bytes ){
+
+			if( std::regex_match( mapping, std::regex("0x[0-9a-fA-F]{8}") ) ){
+
+				bytes[0] = std::stoi( mapping.substr(2, 2) , 0, 16 );
+				bytes[1] = std::stoi( mapping.substr(4, 2) , 0, 16 );
+				bytes[2] = std::stoi( mapping.substr(6, 2) , 0, 16 );
+				bytes[3] = std::stoi( mapping.substr(8, 2) , 0, 16 );
+
+			} else if( _c_keycodes.contains(mapping) ){
+
+				bytes = _c_keycodes.find(mapping)->value;
+
+			} else if( mapping.find("fire") == 0 ){
+
+				std::stringstream mapping_stream(mapping);
+				std::string value1 = "", value2 = "", value3 = "";
+				uint8_t keycode;
+
+				std::getline( mapping_stream, value1, ':' );
+				std::getline( mapping_stream, value1, ':' );
+				std::getline( mapping_stream, value2, ':' );
+				std::getline( mapping_stream, value3, ':' );
+
+				if( value1 == "mouse_left" ){
+					keycode = 0x81;
+				} else if( value1 == "mouse_right" ){
+					keycode = 0x82;
+				} else if( value1 == "mouse_middle" ){
+					keycode = 0x84;
+				} else if( _c_keyboard_key_values.contains(value1) ){
+					keycode = _c_keyboard_key_values.find(value1)->value;
+				} else{
+					return 1;
+				}
+
+				bytes = { 0x99, keycode, (uint8_t)stoi(value2), (uint8_t)stoi(value3) };
+
+			} else if( mapping.find("snipe") == 0 ){
+
+				try{
+					int dpi_value = std::stoi( std::regex_replace( mapping, std::regex("snipe:"), "" ) );
+					for( auto& dpi : _c_snipe_dpi_values ){
+						if( dpi.first == dpi_value ){
+							bytes = { 0x9a, 0x01, dpi.second, dpi.second };
+							return 0;
+						}
+					}
+					return 1;
+				} catch( std::exception& f ){
+					return 1;
+				}
+
+			} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5])") ) ){
+
+				bytes = { 0x91, (uint8_t)(std::stoi( std::regex_replace( mapping, std::regex("macro"), "" ) ) - 1), 0x01, 0x00 };
+
+			} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):\\d+") ) ){
+
+				bytes = { 0x91, (uint8_t)(std::stoi( std::regex_replace( mapping, std::regex("(macro|:\\d+)"), "" ) ) - 1),
+					(uint8_t)std::stoi( std::regex_replace( mapping, std::regex("macro\\d+:"), "" ) ), 0x00 };
+
+			} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):until") ) ){
+
+				bytes = { 0x91, (uint8_t)(std::stoi( std::regex_replace( mapping, std::regex("(macro|:until)"), "" ) ) + 0x3f), 0xff, 0xff };
+
+			} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):while") ) ){
+
+				bytes = { 0x91, (uint8_t)(std::stoi( std::regex_replace( mapping, std::regex("(macro|:while)"), "" ) ) + 0x7f), 0xff, 0xff };
+
+			} else{
+
+				uint8_t first_value = 0x90;
+				uint8_t modifier_value = 0x00;
+				for( auto i : _c_keyboard_modifier_values ){
+					if( mapping.find( i.name ) != std::string::npos ){
+						modifier_value += i.value;
+						first_value = 0x8f;
+					}
+				}
+
+				const auto* key = _c_keyboard_key_values.find( std::regex_replace( mapping, std::regex("[a-z_]*\\+"), "" ) );
+				if( key == nullptr )
+					return 1;
+
+				bytes = { first_value, modifier_value, key->value, 0x00 };
+			}
+
+			return 0;
+		}
+
+		// names of the modifiers
+		static std::vector< std::string > modifiers(){
+			std::vector< std::string > names;
+			for( auto& modifier : _c_keyboard_modifier_values )
+				names.push_back( std::string( modifier.name ) );
+			return names;
+		}
+};
+
+// collect the mappings listed in keymap.md and expand the templates
+std::vector< std::string > read_mappings( const std::string& path ){
+
+	std::ifstream keymap( path );
+	std::vector< std::string > mappings;
+	std::string line;
+
+	while( std::getline( keymap, line ) ){
+
+		// one mapping per line, skip headers, lists, descriptions and templates
+		if( line.empty() || line[0] == '#' || line[0] == '-' || line[0] == '`' ||
+			line.find_first_of( " \t" ) != std::string::npos || line.find( "\xe2\x9f\xa8" ) != std::string::npos )
+			continue;
+
+		mappings.push_back( line );
+	}
+
+	for( int i = 1; i <= 15; i++ ){
+		std::string macro = "macro" + std::to_string(i);
+		for( std::string suffix : { "", ":1", ":25", ":255", ":while", ":until" } )
+			mappings.push_back( macro + suffix );
+	}
+
+	for( std::string button : { "mouse_left", "mouse_right", "mouse_middle", "a", "F5" } )
+		mappings.push_back( "fire:" + button + ":5:1" );
+
+	for( int dpi = 200; dpi <= 1100; dpi += 100 )
+		mappings.push_back( "snipe:" + std::to_string(dpi) );
+
+	for( auto& modifier : bench_mouse::modifiers() )
+		mappings.push_back( modifier + "a" );
+	mappings.push_back( "super_l+shift_l+a" );
+	mappings.push_back( "ctrl_l+alt_r+F12" );
+
+	// raw bytes and invalid mappings
+	for( std::string mapping : { "0x11aa22bb", "0x11aa22bg", "macro0", "macro16", "macro1:", "macro1:x",
+		"snipe:150", "snipe:", "fire:unknown:1:1", "unknown", "ctrl_l+", "" } )
+		mappings.push_back( mapping );
+
+	return mappings;
+}
+
+int main( int argc, char **argv ){
+
+	std::string path = (argc > 1) ? argv[1] : "keymap.md";
+	int iterations = (argc > 2) ? std::stoi( argv[2] ) : 100;
+
+	std::vector< std::string > mappings = read_mappings( path );
+
+	std::cout << "Mappings: " << mappings.size() << "\n";
+	std::cout << "Iterations: " << iterations << "\n";
+
+	// compare results
+	int mismatches = 0;
+	for( auto& mapping : mappings ){
+
+		std::array<uint8_t, 4> expected = {}, bytes = {};
+		int expected_result = bench_mouse::regex_encode_button_mapping( mapping, expected );
+		int result = bench_mouse::_i_encode_button_mapping( mapping, bytes );
+
+		if( result != expected_result || ( result == 0 && bytes != expected ) ){
+			std::cerr << "Mismatch: " << mapping << "\n";
+			mismatches++;
+		}
+	}
+
+	// reference
+	std::array<uint8_t, 4> bytes;
+	int valid = 0;
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		for( auto& mapping : mappings )
+			valid += ( bench_mouse::regex_encode_button_mapping( mapping, bytes ) == 0 );
+	}
+	double regex_total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	// current implementation
+	start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		for( auto& mapping : mappings )
+			valid += ( bench_mouse::_i_encode_button_mapping( mapping, bytes ) == 0 );
+	}
+	double total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	size_t count = mappings.size() * iterations;
+	std::cout << "regex   per_mapping=" << regex_total / count << "us\n";
+	std::cout << "current per_mapping=" << total / count << "us speedup=" << regex_total / total << "\n";
+	std::cout << "valid=" << valid / 2 / iterations << " mismatches=" << mismatches << "\n";
+
+	return ( mismatches == 0 ) ? 0 : 1;
+}
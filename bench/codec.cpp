@@ -0,0 +1,344 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: time and number of allocations per operation of the encoders
+ * and decoders of rd_mouse, simple_ini_parser::read_ini() and print_settings()
+ * of every model, no mouse required.
+ *
+ * Usage: bench_codec [iterations] [baseline] [source directory]
+ *
+ * Inputs:
+ * - button mappings: all key names and the mappings listed in keymap.md
+ * - macros: examples/example.macro, the macros in the example configurations
+ *   and a generated macro with every key
+ * - DPI and lightmode bytes: all 65536 values
+ * - read_ini(): a generated configuration with 1000 profiles
+ * - print_settings(): each model after applying its example configuration
+ *
+ * One line per case is printed: name, ns/op and allocs/op. Lines starting
+ * with # are comments. With a baseline (the output of an earlier run, see
+ * bench/codec_baseline.txt) the values of the baseline and the speedup are
+ * added to each line.
+ */
+
+#include "../include/rd_mouse.h"
+#include "../include/rd_config.h"
+#include "../include/load_config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <type_traits>
+
+// count all allocations
+static size_t allocations = 0;
+
+void* operator new( size_t size ){
+	allocations++;
+	void* pointer = std::malloc( size > 0 ? size : 1 );
+	if( pointer == nullptr )
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete( void* pointer ) noexcept{ std::free( pointer ); }
+void operator delete( void* pointer, size_t ) noexcept{ std::free( pointer ); }
+
+// gives access to the codec functions and the tables of rd_mouse
+class bench_mouse : public rd_mouse{
+
+	public:
+
+		using rd_mouse::_i_encode_button_mapping;
+		using rd_mouse::_i_decode_button_mapping;
+		using rd_mouse::_i_encode_macro;
+		using rd_mouse::_i_decode_macro;
+		using rd_mouse::_i_decode_dpi;
+		using rd_mouse::_i_decode_lightmode;
+		using rd_mouse::_i_encode_report_rate;
+
+		static std::vector< std::string > key_names(){
+			std::vector< std::string > names;
+			for( auto& keycode : _c_keycodes )
+				names.push_back( std::string( keycode.name ) );
+			return names;
+		}
+
+		static std::vector< std::string > keyboard_keys(){
+			std::vector< std::string > names;
+			for( auto& key : _c_keyboard_key_values )
+				names.push_back( std::string( key.name ) );
+			return names;
+		}
+};
+
+// a measured case
+struct result{
+	std::string name;
+	double ns;
+	double allocs;
+};
+
+// time operations calls of function, which performs count operations per call
+template< typename F > result measure( const std::string& name, int iterations, size_t count, F&& function ){
+
+	function(); // warm up
+
+	size_t allocations_before = allocations;
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ )
+		function();
+	double total = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+
+	double operations = (double)iterations * count;
+	return result{ name, total / operations, (allocations - allocations_before) / operations };
+}
+
+// button mappings of keymap.md, one per line without spaces or templates
+std::vector< std::string > read_keymap( const std::string& path ){
+
+	std::vector< std::string > mappings;
+	std::ifstream keymap( path );
+
+	for( std::string line; std::getline( keymap, line ); ){
+		if( line.empty() || line[0] == '#' || line[0] == '-' || line[0] == '`' ||
+			line.find_first_of( " \t" ) != std::string::npos || line.find( "\xe2\x9f\xa8" ) != std::string::npos )
+			continue;
+		mappings.push_back( line );
+	}
+
+	return mappings;
+}
+
+// macro commands of example.macro and of the ;## macro sections of the example configurations
+std::vector< std::string > read_macros( const std::string& examples ){
+
+	std::vector< std::string > macros;
+
+	std::ifstream macro_file( examples + "/example.macro" );
+	macros.push_back( std::string( std::istreambuf_iterator< char >( macro_file ), std::istreambuf_iterator< char >() ) );
+
+	for( std::string name : { "generic", "m607", "m686", "m709", "m711", "m715", "m719", "m721", "m908", "m913", "m990chroma" } ){
+
+		std::ifstream config( examples + "/example_" + name + ".ini" );
+		std::string macro;
+		bool in_macro = false;
+
+		for( std::string line; std::getline( config, line ); ){
+			if( line.rfind( ";## macro", 0 ) == 0 ){
+				if( in_macro )
+					macros.push_back( macro );
+				macro.clear();
+				in_macro = true;
+			} else if( in_macro && line.rfind( ";# ", 0 ) == 0 ){
+				macro += line.substr( 3 ) + "\n";
+			}
+		}
+		if( in_macro )
+			macros.push_back( macro );
+	}
+
+	// every key, the encoder stops at the maximum length
+	std::string macro;
+	for( auto& key : bench_mouse::keyboard_keys() )
+		macro += "down\t" + key + "\ndelay\t5\nup\t" + key + "\nmove_left\t10\n";
+	macros.push_back( macro );
+
+	return macros;
+}
+
+// a configuration with the specified number of profile sections
+std::string generate_config( int sections ){
+
+	std::stringstream config;
+	config << "# generated configuration\n\n";
+
+	for( int i = 1; i <= sections; i++ ){
+
+		config << "[profile" << i << "]\n";
+		config << "lightmode=static\ncolor=ff00" << (i % 10) << "0\nbrightness=0x03\nspeed=0x0" << (i % 9) << "\n";
+		config << "scrollspeed=0x01\nreport_rate=1000\n";
+		for( int j = 1; j < 6; j++ )
+			config << "dpi" << j << "_enable=" << (j % 2) << "\ndpi" << j << "=" << (j * 1200) << "\n";
+		config << "button_left=left\nbutton_right=right\nbutton_middle=middle\nbutton_fire=left_ctrl+w\n";
+		config << "button_1=macro" << (i % 15 + 1) << "\nbutton_2=snipe:400\nbutton_3=media_volume_up\n\n";
+	}
+
+	return config.str();
+}
+
+int main( int argc, char **argv ){
+
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 20;
+	std::string baseline_path = (argc > 2) ? argv[2] : "";
+	std::string source = (argc > 3) ? argv[3] : ".";
+
+	std::vector< result > results;
+
+	// button mappings
+	std::vector< std::string > mappings = bench_mouse::key_names();
+	for( auto& mapping : read_keymap( source + "/keymap.md" ) )
+		mappings.push_back( mapping );
+
+	std::vector< std::array< uint8_t, 4 > > mapping_bytes;
+	for( auto& mapping : mappings ){
+		std::array< uint8_t, 4 > bytes = {};
+		if( bench_mouse::_i_encode_button_mapping( mapping, bytes ) == 0 )
+			mapping_bytes.push_back( bytes );
+	}
+
+	results.push_back( measure( "encode_button_mapping", iterations, mappings.size(), [&](){
+		std::array< uint8_t, 4 > bytes;
+		for( auto& mapping : mappings )
+			bench_mouse::_i_encode_button_mapping( mapping, bytes );
+	} ) );
+
+	results.push_back( measure( "decode_button_mapping", iterations, mapping_bytes.size(), [&](){
+		std::string mapping;
+		for( auto& bytes : mapping_bytes )
+			bench_mouse::_i_decode_button_mapping( bytes, mapping );
+	} ) );
+
+	// macros, the model classes encode at offset 8
+	std::vector< std::string > macros = read_macros( source + "/examples" );
+	std::vector< std::array< uint8_t, 256 > > macro_bytes( macros.size() );
+	for( size_t i = 0; i < macros.size(); i++ ){
+		std::stringstream input( macros[i] );
+		bench_mouse::_i_encode_macro( macro_bytes[i], input, 8 );
+	}
+
+	results.push_back( measure( "encode_macro", iterations, macros.size(), [&](){
+		std::array< uint8_t, 256 > bytes;
+		for( auto& macro : macros ){
+			std::stringstream input( macro );
+			bench_mouse::_i_encode_macro( bytes, input, 8 );
+		}
+	} ) );
+
+	results.push_back( measure( "decode_macro", iterations, macro_bytes.size(), [&](){
+		std::string output;
+		for( auto& bytes : macro_bytes ){
+			output.clear();
+			bench_mouse::_i_decode_macro( bytes.data()+8, bytes.size()-8, output, ";# " );
+		}
+	} ) );
+
+	// all byte values
+	results.push_back( measure( "decode_dpi", iterations, 0x10000, [&](){
+		std::string dpi;
+		for( int i = 0; i < 0x10000; i++ )
+			bench_mouse::_i_decode_dpi( { (uint8_t)(i >> 8), (uint8_t)i }, dpi );
+	} ) );
+
+	results.push_back( measure( "decode_lightmode", iterations, 0x10000, [&](){
+		std::string lightmode;
+		for( int i = 0; i < 0x10000; i++ )
+			bench_mouse::_i_decode_lightmode( { (uint8_t)(i >> 8), (uint8_t)i }, lightmode );
+	} ) );
+
+	// volatile, so the loop is not optimized out
+	volatile uint8_t report_rate = 0;
+	results.push_back( measure( "encode_report_rate", iterations*1000, 4, [&](){
+		for( auto rate : { rd_mouse::r_125Hz, rd_mouse::r_250Hz, rd_mouse::r_500Hz, rd_mouse::r_1000Hz } )
+			report_rate = bench_mouse::_i_encode_report_rate( rate );
+	} ) );
+
+	// configuration file
+	std::string config_path = "bench_codec.ini";
+	{
+		std::ofstream out( config_path );
+		out << generate_config( 1000 );
+	}
+
+	results.push_back( measure( "read_ini", iterations, 1, [&](){
+		simple_ini_parser pt;
+		pt.read_ini( config_path );
+	} ) );
+
+	std::remove( config_path.c_str() );
+
+	// print_settings() of every model
+	for( size_t i = 1; i < std::variant_size_v< rd_mouse::mouse_variant >; i++ ){
+
+		rd_mouse::mouse_variant mouse = rd_mouse::model_registry::create( i );
+
+		std::visit( [&](auto& m){
+			if constexpr( !std::is_same_v< std::decay_t< decltype(m) >, rd_mouse::monostate > ){
+
+				std::string path = source + "/examples/example_" + ( m.get_name() == "generic" ? "" : "m" ) + m.get_name() + ".ini";
+				rd_config config;
+				std::vector< std::string > errors;
+				if( config.load( path, m.lightmode_strings(), m.report_rate_strings(), m.button_names(), errors ) == 0 )
+					config.apply( m, errors );
+
+				results.push_back( measure( "print_settings_" + m.get_name(), iterations, 1, [&](){
+					std::stringstream output;
+					m.print_settings( output );
+				} ) );
+			}
+		}, mouse );
+	}
+
+	// baseline
+	std::vector< result > baseline;
+	if( baseline_path != "" ){
+
+		std::ifstream in( baseline_path );
+		if( !in.is_open() ){
+			std::cerr << "Couldn't open " << baseline_path << "\n";
+			return 1;
+		}
+
+		for( std::string line; std::getline( in, line ); ){
+			if( line.empty() || line[0] == '#' )
+				continue;
+			std::stringstream fields( line );
+			result r;
+			if( fields >> r.name >> r.ns >> r.allocs )
+				baseline.push_back( r );
+		}
+	}
+
+	std::cout << "# iterations=" << iterations << " mappings=" << mappings.size() << " macros=" << macros.size() << "\n";
+	std::cout << "# name ns/op allocs/op" << ( baseline.empty() ? "" : " baseline_ns/op baseline_allocs/op speedup" ) << "\n";
+
+	std::cout << std::fixed;
+	for( auto& r : results ){
+
+		std::cout << std::left << std::setw(24) << r.name << std::right
+			<< " " << std::setprecision(1) << std::setw(12) << r.ns
+			<< " " << std::setprecision(2) << std::setw(10) << r.allocs;
+
+		auto entry = std::find_if( baseline.begin(), baseline.end(), [&]( const result& b ){ return b.name == r.name; } );
+		if( entry != baseline.end() ){
+			std::cout << " " << std::setprecision(1) << std::setw(12) << entry->ns
+				<< " " << std::setprecision(2) << std::setw(10) << entry->allocs
+				<< " " << std::setprecision(2) << std::setw(7) << entry->ns / r.ns;
+		}
+
+		std::cout << "\n";
+	}
+
+	return 0;
+}
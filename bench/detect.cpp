@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: model detection by creating an object of every model for every
+ * device and with the model registry (rd_mouse::model_registry).
+ *
+ * Usage: bench_detect [iterations] [devices]
+ *
+ * No mouse is required, the USB bus is simulated: the given number of
+ * devices (default 32) with unrelated ids followed by one device of each
+ * supported id.
+ */
+
+#include "../include/rd_mouse.h"
+
+#include <chrono>
+
+static constexpr rd_mouse::model_registry models;
+
+// detection as done before the registry: every model is created, from the last to the
+// first index of the variant, and the last matching model wins
+size_t loop_detect( uint16_t vid, uint16_t pid ){
+
+	rd_mouse::mouse_variant mouse = rd_mouse::monostate();
+
+	for( size_t i = rd_mouse::model_registry::model_count(); i-- > 0; ){
+		rd_mouse::mouse_variant candidate = rd_mouse::model_registry::create( i );
+		std::visit( [&](auto& m){
+			if( m.has_vid_pid(vid, pid) ){
+				m.set_vid(vid);
+				m.set_pid(pid);
+				mouse = m;
+			}
+		}, candidate );
+	}
+
+	return mouse.index();
+}
+
+size_t registry_detect( uint16_t vid, uint16_t pid ){
+
+	const rd_mouse::model_registry::rd_model_entry* entry = models.find( vid, pid );
+	if( entry == nullptr )
+		return 0;
+
+	return models.create( *entry ).index();
+}
+
+int main( int argc, char **argv ){
+
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 10;
+	int devices = (argc > 2) ? std::stoi( argv[2] ) : 32;
+
+	// simulated bus
+	std::vector< rd_usb_id > bus;
+	for( int i = 0; i < devices; i++ )
+		bus.push_back( rd_usb_id{ (uint16_t)(0x1000 + i), (uint16_t)(0x0001 + 7*i) } );
+
+	for( size_t i = 0; i < rd_mouse::model_registry::model_count(); i++ ){
+		std::visit( [&](const auto& m){
+			for( const rd_usb_id& id : m.usb_ids() )
+				bus.push_back( id );
+		}, rd_mouse::model_registry::create( i ) );
+	}
+
+	std::cout << "Devices: " << bus.size() << "\n";
+	std::cout << "Iterations: " << iterations << "\n";
+
+	// compare results
+	int mismatches = 0;
+	for( auto& id : bus ){
+		if( loop_detect( id.vid, id.pid ) != registry_detect( id.vid, id.pid ) ){
+			std::cerr << "Mismatch: " << std::hex << id.vid << ":" << id.pid << std::dec << "\n";
+			mismatches++;
+		}
+	}
+
+	// every model
+	size_t found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		for( auto& id : bus )
+			found += ( loop_detect( id.vid, id.pid ) != 0 );
+	}
+	double loop_total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	// registry
+	start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		for( auto& id : bus )
+			found += ( registry_detect( id.vid, id.pid ) != 0 );
+	}
+	double total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "every_model  per_bus=" << loop_total / iterations << "us\n";
+	std::cout << "registry     per_bus=" << total / iterations << "us speedup=" << loop_total / total << "\n";
+	std::cout << "found=" << found / 2 / iterations << " mismatches=" << mismatches << "\n";
+
+	return ( mismatches == 0 ) ? 0 : 1;
+}
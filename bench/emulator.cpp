@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: write → read round trips and write throughput of every wired
+ * model against the in-memory emulator (see rd_emulator), no mouse required.
+ *
+ * Usage: bench_emulator [iterations] [latency us] [interval us] [transfer window]
+ *
+ * For each model, some settings are changed, written and read back by a new
+ * object, the number of lines that differ in the printed settings of both is
+ * shown (the readers of most models do not decode all settings). Then
+ * write_settings() is timed with blocking and with asynchronous transfers,
+ * with differential writes and write_changes() after changing one color.
+ *
+ * Fails if a transfer failed.
+ */
+
+#include "../include/rd_mouse.h"
+#include "../include/emulator.h"
+
+#include <chrono>
+#include <sstream>
+#include <type_traits>
+
+int main( int argc, char **argv ){
+
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 10;
+	unsigned int latency = (argc > 2) ? std::stoi( argv[2] ) : 125;
+	unsigned int interval = (argc > 3) ? std::stoi( argv[3] ) : 25;
+	unsigned int window = (argc > 4) ? std::stoi( argv[4] ) : 8;
+
+	std::cout << "Iterations: " << iterations << "\n";
+	std::cout << "Latency: " << latency << "us interval: " << interval << "us\n";
+
+	int failures = 0;
+
+	for( size_t i = 1; i < std::variant_size_v< rd_mouse::mouse_variant >; i++ ){
+
+		rd_mouse::mouse_variant mouse = rd_mouse::model_registry::create( i );
+
+		std::visit( [&](auto& m){
+
+			typedef std::decay_t< decltype(m) > T;
+			if constexpr( !std::is_same_v< T, rd_mouse::monostate > && !std::is_base_of_v< rd_mouse_wireless, T > ){
+
+				rd_emulator emulator;
+				m.set_transport( &emulator );
+				m.open_mouse();
+
+				std::cout << "Model: " << m.get_name() << "\n";
+
+				// round trip
+				m.set_lightmode( rd_mouse::profile_1, rd_mouse::lightmode_breathing );
+				m.set_color( rd_mouse::profile_1, {0x12, 0x34, 0x56} );
+				m.set_report_rate( rd_mouse::profile_2, rd_mouse::r_500Hz );
+				m.write_settings();
+
+				T read;
+				read.set_transport( &emulator );
+				read.open_mouse();
+				read.read_settings();
+
+				std::stringstream written, received;
+				m.print_settings( written );
+				read.print_settings( received );
+
+				int lines = 0, differing = 0;
+				std::string line_written, line_received;
+				while( std::getline( written, line_written ) ){
+					std::getline( received, line_received );
+					lines++;
+					differing += ( line_written != line_received );
+				}
+
+				std::cout << "round_trip differing_lines=" << differing << "/" << lines
+					<< " bytes_written=" << emulator.get_stats().bytes_written << "\n";
+
+				// throughput
+				emulator.set_latency( latency, interval );
+
+				auto time = [&]( const char* name, auto&& write ){
+
+					emulator.reset_stats();
+					int failed = 0;
+
+					auto start = std::chrono::steady_clock::now();
+					for( int j = 0; j < iterations; j++ )
+						failed += write( j );
+					double total = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+					failures += failed;
+					std::cout << name
+						<< " per_write=" << total / iterations << "ms"
+						<< " transfers=" << (emulator.get_stats().writes + emulator.get_stats().reads + emulator.get_stats().others) / iterations
+						<< " failed=" << failed << "\n";
+				};
+
+				for( unsigned int w : { 1u, window } ){
+					m.set_transfer_window( w );
+					time( (w == 1) ? "synchronous " : "pipelined   ", [&]( int ){ return m.write_settings(); } );
+				}
+
+				m.set_differential_write( true );
+				time( "differential", [&]( int ){ return m.write_settings(); } );
+				std::cout << "skipped_packets=" << m.get_skipped_packets() << "\n";
+				m.set_differential_write( false );
+
+				m.write_changes();
+				time( "changes     ", [&]( int j ){
+					m.set_color( rd_mouse::profile_1, {(uint8_t)j, 0x34, 0x56} );
+					return m.write_changes();
+				} );
+
+				read.close_mouse();
+				m.close_mouse();
+			}
+		}, mouse );
+	}
+
+	std::cout << "failed=" << failures << "\n";
+
+	return ( failures == 0 ) ? 0 : 1;
+}
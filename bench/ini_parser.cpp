@@ -0,0 +1,169 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: parse time of simple_ini_parser::read_ini() on a generated
+ * configuration, compared to the previous regex based implementation.
+ *
+ * Usage: bench_ini_parser [sections] [iterations]
+ *
+ * The generated file contains the keys of a real configuration, comments,
+ * whitespace, duplicate keys and invalid lines. Both parsers must produce
+ * the same key-value pairs, otherwise the benchmark fails.
+ */
+
+#include "../include/load_config.h"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <regex>
+#include <sstream>
+
+// the previous implementation of simple_ini_parser::read_ini(), as a reference
+int regex_read_ini( const std::string& path, std::map< std::string, std::string >& values ){
+
+	std::ifstream inifile( path );
+	if( !inifile.is_open() )
+		return 1;
+
+	std::string line, current_section = "";
+
+	while( std::getline( inifile, line ) ){
+
+		if( line.length() == 0 )
+			continue;
+
+		if( line[0] == ';' || line[0] == '#' )
+			continue;
+
+		line = std::regex_replace( line, std::regex("[[:space:]]"), "" );
+
+		if( std::regex_match( line, std::regex("\\[[[:print:]]+\\]") ) ){
+			current_section = std::regex_replace( line, std::regex("[\\[\\]]"), "" ) + ".";
+			continue;
+		}
+
+		if( std::regex_match( line, std::regex("[[:print:]]+=[[:print:]]+") ) ){
+			values.emplace( current_section + std::regex_replace( line, std::regex("=[[:print:]]+"), "" ),
+				std::regex_replace( line, std::regex("[[:print:]]+="), "" ) );
+		}
+	}
+
+	return 0;
+}
+
+// generate a configuration with the specified number of sections
+std::string generate_config( int sections ){
+
+	std::stringstream config;
+	config << "# generated configuration\n; second comment style\n\n";
+
+	for( int i = 1; i <= sections; i++ ){
+
+		config << ( i % 7 == 0 ? " [ profile" : "[profile" ) << i << "]\r\n";
+		config << "lightmode=static\n";
+		config << "color = ff00" << (i % 10) << "0\n";
+		config << "\tbrightness=0x03\n";
+		config << "speed=0x" << (i % 9) << "\n";
+		config << "scrollspeed=0x01\n";
+		config << "report_rate=1000\n";
+
+		for( int j = 1; j < 6; j++ ){
+			config << "dpi" << j << "_enable=" << (j % 2) << "\n";
+			config << "dpi" << j << "=" << (j * 1200) << "\n";
+		}
+
+		config << "button_left=left\n";
+		config << "button_right=right\n";
+		config << "button_middle=middle\n";
+		config << "button_fire=left_ctrl + w\n";
+		config << "button_1=macro" << (i % 15 + 1) << "\n";
+		config << "button_2=snipe:400\n";
+		config << "button_3=media_volume_up\n";
+		config << "button_4=forward\n";
+
+		// duplicates, comments and invalid lines
+		config << "lightmode=off\n";
+		config << "   ;not a comment=1\n";
+		config << "# speed=0x02\n";
+		config << "missing_value=\n";
+		config << "=missing_key\n";
+		config << "a=b=c\n";
+		config << "=x=y\n";
+		config << "x==\n";
+		config << "not printable=\x01\n";
+		config << "\n";
+	}
+
+	return config.str();
+}
+
+int main( int argc, char **argv ){
+
+	int sections = (argc > 1) ? std::stoi( argv[1] ) : 1000;
+	int iterations = (argc > 2) ? std::stoi( argv[2] ) : 5;
+
+	std::string path = "bench_ini_parser.ini";
+	{
+		std::ofstream out( path, std::ios::binary );
+		out << generate_config( sections );
+	}
+
+	std::cout << "Sections: " << sections << "\n";
+	std::cout << "Iterations: " << iterations << "\n";
+
+	// reference
+	std::map< std::string, std::string > reference;
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		reference.clear();
+		regex_read_ini( path, reference );
+	}
+	double regex_total = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	// current implementation
+	start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		simple_ini_parser pt;
+		pt.read_ini( path );
+	}
+	double total = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	// compare results, print_all() prints the key-value pairs sorted like std::map
+	simple_ini_parser pt;
+	pt.read_ini( path );
+	std::remove( path.c_str() );
+
+	std::stringstream expected, printed;
+	for( auto& value : reference )
+		expected << value.first << "=" << value.second << "\n";
+
+	std::streambuf* cout_buffer = std::cout.rdbuf( printed.rdbuf() );
+	pt.print_all();
+	std::cout.rdbuf( cout_buffer );
+
+	bool match = ( expected.str() == printed.str() );
+
+	std::cout << "regex   keys=" << reference.size() << " per_parse=" << regex_total / iterations << "ms\n";
+	std::cout << "current per_parse=" << total / iterations << "ms"
+		<< " speedup=" << regex_total / total << "\n";
+	std::cout << "results " << ( match ? "match" : "DIFFER" ) << "\n";
+
+	return match ? 0 : 1;
+}
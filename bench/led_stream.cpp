@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: achieved frame rate and per-frame latency of rd_led_stream.
+ *
+ * Usage: bench_led_stream [frame rate] [colors] [push rate]
+ *
+ * A color wheel is pushed at the push rate (default 120 per second) and
+ * streamed to the LED of profile 1 at the frame rate (default 60), colors
+ * that could not be sent in time are dropped. The LED of profile 1 is left
+ * in lightmode static, the other settings of the mouse are not changed.
+ */
+
+#include "../include/rd_mouse.h"
+#include "../include/led_stream.h"
+
+#include <chrono>
+#include <thread>
+
+// this allows the creation of overloaded lambda functions
+template< typename T1, typename T2 > struct overload : T1, T2  {
+	overload(T1 a, T2 b) : T1(a), T2(b) {};
+	using T1::operator();
+	using T2::operator();
+};
+
+// a fully saturated color, position 0-1535 on the color wheel
+std::array< uint8_t, 3 > wheel( int position ){
+
+	uint8_t rising = position % 256, falling = 255 - rising;
+	switch( (position / 256) % 6 ){
+		case 0: return { 255, rising, 0 };
+		case 1: return { falling, 255, 0 };
+		case 2: return { 0, 255, rising };
+		case 3: return { 0, falling, 255 };
+		case 4: return { rising, 0, 255 };
+		default: return { 255, 0, falling };
+	}
+}
+
+int main( int argc, char **argv ){
+
+	double frame_rate = (argc > 1) ? std::stod( argv[1] ) : 60;
+	int colors = (argc > 2) ? std::stoi( argv[2] ) : 600;
+	double push_rate = (argc > 3) ? std::stod( argv[3] ) : 120;
+
+	rd_mouse::mouse_variant mouse = rd_mouse::detect();
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		std::cerr << "Couldn't detect mouse.\n";
+		return 1;
+	}
+
+	int res = 0;
+	auto run = overload(
+		[](rd_mouse::monostate){},
+		[&](auto& m){
+
+			if( m.open_mouse() != 0 ){
+				std::cerr << "Couldn't open mouse.\n";
+				res = 1;
+				return;
+			}
+
+			if( rd_led_stream::prepare( m, rd_mouse::profile_1 ) != 0 ){
+				std::cerr << "LED streaming is not supported by this mouse.\n";
+				m.close_mouse();
+				res = 1;
+				return;
+			}
+
+			std::cout << "Model: " << m.get_name() << "\n";
+			std::cout << "Frame rate: " << frame_rate << " push rate: " << push_rate << " colors: " << colors << "\n";
+
+			rd_led_stream stream( frame_rate );
+			std::thread sender( [&](){ stream.run( m, rd_mouse::profile_1 ); } );
+
+			// push the colors at a fixed rate
+			auto interval = std::chrono::duration< double >( 1.0 / push_rate );
+			auto start = std::chrono::steady_clock::now();
+			for( int i = 0; i < colors; i++ ){
+				std::this_thread::sleep_until( start + std::chrono::duration_cast< std::chrono::steady_clock::duration >( interval * i ) );
+				stream.push( wheel( i * 8 ) );
+			}
+
+			stream.close();
+			sender.join();
+
+			auto stats = stream.get_stats();
+			double achieved = ( stats.duration > 0 ) ? (stats.frames-1) / stats.duration * 1e6 : 0;
+			std::cout << "frames=" << stats.frames
+				<< " achieved_fps=" << achieved
+				<< " latency_avg=" << ( stats.frames > 0 ? stats.latency_total / stats.frames / 1000 : 0 ) << "ms"
+				<< " latency_max=" << stats.latency_max / 1000 << "ms"
+				<< " dropped=" << stats.dropped
+				<< " failed=" << stats.failed << "\n";
+
+			m.close_mouse();
+		}
+	);
+
+	std::visit( [&](auto&& arg){ run(arg); }, mouse );
+
+	return res;
+}
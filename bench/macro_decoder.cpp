@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Benchmark: time to decode a bank of 15 macros with
+ * rd_mouse::_i_decode_macros(), compared to the previous if/else
+ * based implementation of rd_mouse::_i_decode_macro().
+ *
+ * Usage: bench_macro_decoder [iterations]
+ *
+ * The bank contains macros with every kind of code (mouse buttons, keys,
+ * delays, movements, repeats) and unknown codes. Both implementations
+ * must print the same commands, otherwise the benchmark fails.
+ */
+
+#include "../include/rd_mouse.h"
+
+#include <chrono>
+
+// gives access to the decoding functions and the tables of rd_mouse
+class bench_mouse : public rd_mouse{
+
+	public:
+
+		using rd_mouse::_i_decode_macros;
+
+		// the previous implementation of rd_mouse::_i_decode_macro(), as a reference
+		// (macro_bytes must be followed by two readable bytes)
+		static void reference_decode_macro( const uint8_t* macro_bytes, size_t size, std::ostream& output, const std::string& prefix ){
+
+			for( size_t i = 0; i < size; ){
+
+				bool unknown_code = false;
+
+				if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x01 )
+					output << prefix << "down\tmouse_left\n";
+				else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x02 )
+					output << prefix << "down\tmouse_right\n";
+				else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x04 )
+					output << prefix << "down\tmouse_middle\n";
+				else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x01 )
+					output << prefix << "up\tmouse_left\n";
+				else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x02 )
+					output << prefix << "up\tmouse_right\n";
+				else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x04 )
+					output << prefix << "up\tmouse_middle\n";
+				else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x10 )
+					output << prefix << "down\tmouse_forward\n";
+				else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x10 )
+					output << prefix << "up\tmouse_forward\n";
+				else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x08 )
+					output << prefix << "down\tmouse_backward\n";
+				else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x08 )
+					output << prefix << "up\tmouse_backward\n";
+				else if( macro_bytes[i] == 0x81 || macro_bytes[i] == 0x01 )
+					unknown_code = true;
+				else if( macro_bytes[i] == 0x84 || macro_bytes[i] == 0x04 ){
+
+					// scan all keys, like the previous std::map lookup
+					bool found = false;
+					for( auto& key : _c_keyboard_key_values ){
+						if( key.value == macro_bytes[i+1] ){
+							output << prefix << ( macro_bytes[i] == 0x84 ? "down\t" : "up\t" ) << key.name << "\n";
+							found = true;
+							break;
+						}
+					}
+					unknown_code = !found;
+
+				} else if( macro_bytes[i] == 0x06 ){
+					output << prefix << "delay\t" << (int)macro_bytes[i+1] << "\n";
+				} else if( macro_bytes[i] == 0x02 ){
+
+					if( macro_bytes[i+2] == 0x00 ){
+						if( macro_bytes[i+1] >= 0x88 )
+							output << prefix << "move_left\t" << (int)((int8_t)macro_bytes[i+1] * (-1)) << "\n";
+						else if( macro_bytes[i+1] <= 0x78 )
+							output << prefix << "move_right\t" << (int)macro_bytes[i+1] << "\n";
+						else
+							unknown_code = true;
+					} else if( macro_bytes[i+1] == 0x00 ){
+						if( (int)macro_bytes[i+2] >= 0x88 )
+							output << prefix << "move_up\t" << (int)((int8_t)macro_bytes[i+2] * (-1)) << "\n";
+						else if( macro_bytes[i+2] <= 0x78 )
+							output << prefix << "move_down\t" << (int)macro_bytes[i+2] << "\n";
+						else
+							unknown_code = true;
+					} else
+						unknown_code = true;
+
+				} else if( macro_bytes[i] == 0xff ){
+					output << prefix << "repeat\t" << (int)macro_bytes[i+1] + (int)macro_bytes[i+2]*256 << "\n";
+				} else if( macro_bytes[i] == 0x00 ){
+					i++;
+				} else{
+					unknown_code = true;
+				}
+
+				if( unknown_code ){
+					output << prefix << "unknown, please report as bug: ";
+					output << std::hex << (int)macro_bytes[i] << " ";
+					output << std::hex << (int)macro_bytes[i+1] << " ";
+					output << std::hex << (int)macro_bytes[i+2];
+					output << std::dec << "\n";
+				}
+
+				i+=3;
+			}
+		}
+
+		// the previous dump loop
+		static void reference_decode_macros( const std::array< std::array< uint8_t, 258 >, 15 >& macro_data, std::ostream& output ){
+
+			output << "\n# Macros\n";
+			for( int i = 0; i < 15; i++ ){
+
+				if( macro_data[i][8] == 0 && macro_data[i][9] == 0 && macro_data[i][10] == 0 )
+					continue;
+
+				output << "\n;## macro" << i+1 << "\n";
+				reference_decode_macro( macro_data[i].data() + 8, 248, output, ";# " );
+			}
+		}
+};
+
+// fill a bank with macros that use every kind of code
+std::array< std::array< uint8_t, 256 >, 15 > generate_bank(){
+
+	std::array< std::array< uint8_t, 256 >, 15 > bank = {};
+	uint32_t state = 12345;
+	auto next = [&state](){ state = state * 1103515245 + 12345; return (uint8_t)(state >> 16); };
+
+	const uint8_t opcodes[] = { 0x81, 0x01, 0x84, 0x04, 0x06, 0x02, 0xff, 0x42 };
+
+	for( size_t i = 0; i < bank.size(); i++ ){
+
+		// leave some macros undefined
+		if( i % 5 == 4 )
+			continue;
+
+		// up to 80 codes, followed by padding
+		size_t codes = 20 + i * 4;
+		for( size_t j = 0; j < codes && 8 + j*3 + 2 < 256; j++ ){
+
+			uint8_t* code = &bank[i][8 + j*3];
+			code[0] = opcodes[ next() % std::size(opcodes) ];
+			code[1] = next();
+			code[2] = ( code[0] == 0x02 && next() % 2 ) ? 0x00 : next();
+
+			// mostly valid mouse buttons and movements
+			if( ( code[0] == 0x81 || code[0] == 0x01 ) && next() % 4 )
+				code[1] = 1 << ( next() % 5 );
+			if( code[0] == 0x02 && next() % 4 )
+				code[1] = 0x00;
+		}
+	}
+
+	return bank;
+}
+
+int main( int argc, char **argv ){
+
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 10000;
+
+	std::array< std::array< uint8_t, 256 >, 15 > bank = generate_bank();
+
+	// the reference reads up to two bytes past the end of a macro
+	std::array< std::array< uint8_t, 258 >, 15 > padded_bank = {};
+	for( size_t i = 0; i < bank.size(); i++ )
+		std::copy( bank[i].begin(), bank[i].end(), padded_bank[i].begin() );
+
+	std::cout << "Iterations: " << iterations << "\n";
+
+	// compare results
+	std::stringstream expected, decoded;
+	bench_mouse::reference_decode_macros( padded_bank, expected );
+	bench_mouse::_i_decode_macros( bank, decoded, 8 );
+	bool match = ( expected.str() == decoded.str() );
+
+	// reference
+	size_t length = 0;
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		std::stringstream output;
+		bench_mouse::reference_decode_macros( padded_bank, output );
+		length += output.str().length();
+	}
+	double reference_total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	// current implementation
+	start = std::chrono::steady_clock::now();
+	for( int i = 0; i < iterations; i++ ){
+		std::stringstream output;
+		bench_mouse::_i_decode_macros( bank, output, 8 );
+		length += output.str().length();
+	}
+	double total = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "reference per_bank=" << reference_total / iterations << "us\n";
+	std::cout << "current   per_bank=" << total / iterations << "us speedup=" << reference_total / total << "\n";
+	std::cout << "output=" << length / 2 / iterations << " bytes, results " << ( match ? "match" : "DIFFER" ) << "\n";
+
+	return match ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+/*
+ * Benchmark: wall-clock time of write_settings() with blocking transfers
+ * and with asynchronous transfers (see rd_mouse::set_transfer_window).
+ *
+ * Usage: bench_write_settings [iterations] [transfer window]
+ *
+ * The settings are read from the mouse first and written back unchanged.
+ */
+
+#include "../include/rd_mouse.h"
+
+#include <chrono>
+
+// this allows the creation of overloaded lambda functions
+template< typename T1, typename T2 > struct overload : T1, T2  {
+	overload(T1 a, T2 b) : T1(a), T2(b) {};
+	using T1::operator();
+	using T2::operator();
+};
+
+int main( int argc, char **argv ){
+	
+	int iterations = (argc > 1) ? std::stoi( argv[1] ) : 10;
+	unsigned int window = (argc > 2) ? std::stoi( argv[2] ) : 8;
+	
+	rd_mouse::mouse_variant mouse = rd_mouse::detect();
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		std::cerr << "Couldn't detect mouse.\n";
+		return 1;
+	}
+	
+	int res = 0;
+	auto run = overload(
+		[](rd_mouse::monostate){},
+		[&](auto& m){
+			
+			if( m.open_mouse() != 0 ){
+				std::cerr << "Couldn't open mouse.\n";
+				res = 1;
+				return;
+			}
+			
+			// write the current settings back to the mouse
+			m.read_settings();
+			
+			std::cout << "Model: " << m.get_name() << "\n";
+			std::cout << "Iterations: " << iterations << "\n";
+			
+			for( unsigned int w : { 1u, window } ){
+				
+				m.set_transfer_window( w );
+				int failed = 0;
+				
+				auto start = std::chrono::steady_clock::now();
+				for( int i = 0; i < iterations; i++ )
+					failed += m.write_settings();
+				auto end = std::chrono::steady_clock::now();
+				
+				double total = std::chrono::duration<double, std::milli>( end - start ).count();
+				std::cout << (w == 1 ? "synchronous" : "pipelined  ")
+					<< " window=" << w
+					<< " total=" << total << "ms"
+					<< " per_write=" << total / iterations << "ms"
+					<< " failed_packets=" << failed << "\n";
+			}
+			
+			m.close_mouse();
+		}
+	);
+	
+	std::visit( [&](auto&& arg){ run(arg); }, mouse );
+	
+	return res;
+}
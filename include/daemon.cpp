@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "daemon.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+volatile int rd_daemon::_i_stop = 0;
+
+void rd_daemon::_i_handle_signal( int signal ){
+	(void)signal;
+	_i_stop = 1;
+}
+
+int rd_daemon::_i_write_all( int fd, const std::string& data ){
+
+	size_t written = 0;
+
+	while( written < data.size() ){
+
+		ssize_t res = write( fd, data.data() + written, data.size() - written );
+
+		if( res < 0 && errno == EINTR )
+			continue;
+		if( res <= 0 )
+			return 1;
+
+		written += res;
+	}
+
+	return 0;
+}
+
+bool rd_daemon::_i_peer_allowed( int fd ){
+
+	uid_t uid;
+
+#if defined(SO_PEERCRED)
+	ucred credentials;
+	socklen_t length = sizeof(credentials);
+	if( getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length ) != 0 )
+		return false;
+	uid = credentials.uid;
+#else
+	gid_t gid;
+	if( getpeereid( fd, &uid, &gid ) != 0 )
+		return false;
+#endif
+
+	return uid == geteuid() || uid == 0;
+}
+
+int rd_daemon::_i_read_all( int fd, std::string& data ){
+
+	char buffer[4096];
+
+	while( true ){
+
+		ssize_t res = read( fd, buffer, sizeof(buffer) );
+
+		if( res < 0 && errno == EINTR )
+			continue;
+		if( res < 0 )
+			return 1;
+		if( res == 0 )
+			break;
+
+		data.append( buffer, res );
+	}
+
+	return 0;
+}
+
+int rd_daemon::serve( const std::string& path, request_handler handler ){
+
+	sockaddr_un address;
+	std::memset( &address, 0, sizeof(address) );
+	address.sun_family = AF_UNIX;
+
+	if( path.size() >= sizeof(address.sun_path) )
+		return 1;
+	std::strncpy( address.sun_path, path.c_str(), sizeof(address.sun_path)-1 );
+
+	// create socket, remove stale socket files left by a previous daemon (but no other files)
+	int server = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( server < 0 )
+		return 1;
+
+	struct stat status;
+	if( lstat( path.c_str(), &status ) == 0 && S_ISSOCK( status.st_mode ) )
+		unlink( path.c_str() );
+
+	// the socket file is created with mode 0600, other users can not connect
+	mode_t mask = umask( 0077 );
+	int bound = bind( server, (sockaddr*)&address, sizeof(address) );
+	umask( mask );
+
+	if( bound != 0 || chmod( path.c_str(), 0600 ) != 0 || listen( server, 8 ) != 0 ){
+		close( server );
+		return 1;
+	}
+
+	// stop on SIGINT and SIGTERM, accept() must not be restarted after a signal
+	struct sigaction action;
+	std::memset( &action, 0, sizeof(action) );
+	action.sa_handler = _i_handle_signal;
+	sigemptyset( &action.sa_mask );
+	action.sa_flags = 0;
+	sigaction( SIGINT, &action, NULL );
+	sigaction( SIGTERM, &action, NULL );
+
+	// a client closing the connection early must not terminate the daemon
+	signal( SIGPIPE, SIG_IGN );
+
+	_i_stop = 0;
+	while( !_i_stop ){
+
+		int client = accept( server, NULL, NULL );
+		if( client < 0 ){
+			if( errno == EINTR )
+				continue;
+			break;
+		}
+
+		// read request, a client that does not finish its request must not block the daemon
+		timeval timeout = { _c_request_timeout, 0 };
+		setsockopt( client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+
+		std::string request;
+		if( _i_read_all( client, request ) != 0 ){
+			close( client );
+			continue;
+		}
+
+		// split request: working directory, then the arguments
+		std::vector< std::string > args;
+		std::string working_directory;
+		size_t position = 0;
+		bool first = true;
+
+		while( position < request.size() ){
+
+			size_t end = request.find( '\0', position );
+			if( end == std::string::npos )
+				end = request.size();
+
+			if( first )
+				working_directory = request.substr( position, end-position );
+			else
+				args.push_back( request.substr( position, end-position ) );
+
+			first = false;
+			position = end+1;
+		}
+
+		// handle request
+		std::stringstream output, error_output;
+		int status = 1;
+
+		if( !_i_peer_allowed( client ) ){
+			error_output << "Requests are only accepted from the user of the daemon and root.\n";
+		} else if( working_directory.empty() || chdir( working_directory.c_str() ) != 0 ){
+			error_output << "Couldn't change to the working directory of the client.\n";
+		} else{
+			status = handler( args, output, error_output );
+		}
+
+		// send response
+		std::string output_string = output.str();
+		std::string error_string = error_output.str();
+
+		std::stringstream response;
+		response << status << " " << output_string.size() << " " << error_string.size() << "\n";
+		response << output_string << error_string;
+
+		_i_write_all( client, response.str() );
+		close( client );
+	}
+
+	close( server );
+	unlink( path.c_str() );
+
+	return 0;
+}
+
+int rd_daemon::send_request( const std::string& path, const std::vector< std::string >& args, std::ostream& output, std::ostream& error_output ){
+
+	sockaddr_un address;
+	std::memset( &address, 0, sizeof(address) );
+	address.sun_family = AF_UNIX;
+
+	if( path.size() >= sizeof(address.sun_path) ){
+		error_output << "Socket path too long: " << path << "\n";
+		return 1;
+	}
+	std::strncpy( address.sun_path, path.c_str(), sizeof(address.sun_path)-1 );
+
+	int server = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( server < 0 || connect( server, (sockaddr*)&address, sizeof(address) ) != 0 ){
+		error_output << "Couldn't connect to the daemon at " << path << "\n";
+		if( server >= 0 )
+			close( server );
+		return 1;
+	}
+
+	// build request
+	char working_directory[4096];
+	if( getcwd( working_directory, sizeof(working_directory) ) == NULL ){
+		close( server );
+		error_output << "Couldn't get the working directory.\n";
+		return 1;
+	}
+
+	std::string request( working_directory );
+	request.push_back( '\0' );
+	for( auto& arg : args ){
+		request += arg;
+		request.push_back( '\0' );
+	}
+
+	// send request, then signal the end of the request
+	if( _i_write_all( server, request ) != 0 ){
+		close( server );
+		error_output << "Couldn't send the request to the daemon.\n";
+		return 1;
+	}
+	shutdown( server, SHUT_WR );
+
+	// receive and parse response
+	std::string response;
+	int res = _i_read_all( server, response );
+	close( server );
+
+	size_t header_end = response.find( '\n' );
+	if( res != 0 || header_end == std::string::npos ){
+		error_output << "Invalid response from the daemon.\n";
+		return 1;
+	}
+
+	int status = 1;
+	size_t output_length = 0, error_length = 0;
+	std::stringstream header( response.substr( 0, header_end ) );
+	header >> status >> output_length >> error_length;
+
+	if( header.fail() || header_end + 1 + output_length + error_length > response.size() ){
+		error_output << "Invalid response from the daemon.\n";
+		return 1;
+	}
+
+	output << response.substr( header_end + 1, output_length );
+	error_output << response.substr( header_end + 1 + output_length, error_length );
+
+	return status;
+}
@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_DAEMON
+#define RD_DAEMON
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * This class implements the communication between mouse_m908 --daemon
+ * and mouse_m908 --socket over a unix domain socket.
+ *
+ * The daemon keeps the mouse open, so that a request does not pay for
+ * initializing libusb, detecting, opening and closing the mouse.
+ *
+ * A request consists of the working directory of the client followed by
+ * the command line arguments, each terminated by '\0'. The response
+ * starts with a line containing the exit status and the length of the
+ * standard output and error output, followed by both outputs.
+ */
+class rd_daemon{
+
+	public:
+
+		/** \brief Handles a single request
+		 * \arg args the command line arguments of the client
+		 * \arg output receives everything that the client prints to stdout
+		 * \arg error_output receives everything that the client prints to stderr
+		 * \return the exit status for the client
+		 */
+		typedef std::function< int( const std::vector< std::string >& args, std::ostream& output, std::ostream& error_output ) > request_handler;
+
+		/** \brief Listen on the specified socket and pass every request to handler
+		 * The working directory is changed to the one of the client before calling handler.
+		 * Returns after SIGINT or SIGTERM has been received, the socket file is removed.
+		 * An existing socket file at path is replaced, any other file makes this fail.
+		 * The socket is only accessible by the user of the daemon (mode 0600), requests from
+		 * other users except root are rejected.
+		 * \return 0 if successful
+		 */
+		static int serve( const std::string& path, request_handler handler );
+
+		/** \brief Send a request to the daemon listening on the specified socket
+		 * \return the exit status sent by the daemon, or 1 if the daemon could not be reached
+		 */
+		static int send_request( const std::string& path, const std::vector< std::string >& args, std::ostream& output, std::ostream& error_output );
+
+	private:
+
+		/// Seconds a client may take to send its request, the connection is closed afterwards
+		static const int _c_request_timeout = 5;
+
+		/// Set by the signal handler to stop serve()
+		static volatile int _i_stop;
+
+		/// Signal handler for SIGINT and SIGTERM
+		static void _i_handle_signal( int signal );
+
+		/// Write all bytes to fd, returns 0 if successful
+		static int _i_write_all( int fd, const std::string& data );
+
+		/// Read from fd until EOF, returns 0 if successful
+		static int _i_read_all( int fd, std::string& data );
+		
+		/// Whether the client connected to fd runs as the user of the daemon or as root
+		static bool _i_peer_allowed( int fd );
+};
+
+#endif
@@ -31,8 +31,10 @@ const uint8_t rd_mouse::_c_level_min = 0, rd_mouse::_c_level_max = 4;
 const uint8_t rd_mouse::_c_dpi_min = 0x04, rd_mouse::_c_dpi_max = 0x8c;
 const uint8_t rd_mouse::_c_dpi_2_min = 0x00, rd_mouse::_c_dpi_2_max = 0x01;
 
+// the lookup tables are sorted and indexed at compile time, see rd_lookup_table.h
+
 //name → keycode
-std::map< std::string, std::array<uint8_t, 4> > rd_mouse::_c_keycodes = {
+static constexpr rd_named_value< std::array<uint8_t, 4> > keycodes[] = {
 	{ "left", { 0x81, 0x00, 0x00, 0x00 } },
 	{ "right", { 0x82, 0x00, 0x00, 0x00 } },
 	{ "middle", { 0x83, 0x00, 0x00, 0x00 } },
@@ -81,9 +83,12 @@ std::map< std::string, std::array<uint8_t, 4> > rd_mouse::_c_keycodes = {
 	{ "compatibility_browser_search", { 0x8e, 0x01, 0xff, 0x24} },
 	{ "compatibility_browser_favorite", { 0x8e, 0x01, 0xff, 0x25} },
 	{ "compatibility_mail", { 0x8e, 0x01, 0xff, 0x26} }	};
+static constexpr rd_lookup_table_data< std::array<uint8_t, 4>, std::size(keycodes) > keycodes_data( keycodes );
+static_assert( keycodes_data.unique_names(), "duplicate name" );
+const rd_lookup_table< std::array<uint8_t, 4> > rd_mouse::_c_keycodes = keycodes_data.table();
 
 //modifier name → value
-const std::map< std::string, uint8_t > rd_mouse::_c_keyboard_modifier_values = {
+static constexpr rd_named_value< uint8_t > keyboard_modifier_values[] = {
 	{ "ctrl_l+", 1 },
 	{ "shift_l+", 2 },
 	{ "alt_l+", 4 },
@@ -92,9 +97,12 @@ const std::map< std::string, uint8_t > rd_mouse::_c_keyboard_modifier_values = {
 	{ "shift_r+", 32 },
 	{ "alt_r+", 64 },
 	{ "super_r+", 128 } };
+static constexpr rd_lookup_table_data< uint8_t, std::size(keyboard_modifier_values) > keyboard_modifier_values_data( keyboard_modifier_values );
+static_assert( keyboard_modifier_values_data.unique_names(), "duplicate name" );
+const rd_lookup_table< uint8_t > rd_mouse::_c_keyboard_modifier_values = keyboard_modifier_values_data.table();
 
 //keyboard key name → value
-std::map< std::string, uint8_t > rd_mouse::_c_keyboard_key_values = {
+static constexpr rd_named_value< uint8_t > keyboard_key_values[] = {
 	//top row
 	{ "Esc", 0x29 },
 	{ "F1", 0x3a },
@@ -278,8 +286,12 @@ std::map< std::string, uint8_t > rd_mouse::_c_keyboard_key_values = {
 	{ "Media_Screenlock", 0xf9 },
 	{ "Media_Refresh", 0xfa },
 	{ "Media_Calc", 0xfb } };
+static constexpr rd_lookup_table_data< uint8_t, std::size(keyboard_key_values) > keyboard_key_values_data( keyboard_key_values );
+static_assert( keyboard_key_values_data.unique_names(), "duplicate name" );
+const rd_lookup_table< uint8_t > rd_mouse::_c_keyboard_key_values = keyboard_key_values_data.table();
 
-std::map< int, uint8_t >  rd_mouse::_c_snipe_dpi_values = {
+//snipe DPI → value, sorted by DPI
+const std::array< std::pair< int, uint8_t >, 10 > rd_mouse::_c_snipe_dpi_values = {{
 	{ 200, 0x04 },
 	{ 300, 0x06 },
 	{ 400, 0x09 },
@@ -290,7 +302,7 @@ std::map< int, uint8_t >  rd_mouse::_c_snipe_dpi_values = {
 	{ 900, 0x14 },
 	{ 1000, 0x16 },
 	{ 1100, 0x18 }
-};
+}};
 
 std::map< uint8_t, rd_mouse::rd_report_rate > rd_mouse::_c_report_rate_values = {
 	{ 8, rd_mouse::r_125Hz },
@@ -0,0 +1,160 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "emulator.h"
+
+#include <algorithm>
+#include <thread>
+
+int rd_emulator::control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint8_t* data, uint16_t length, unsigned int timeout ){
+
+	(void)value;
+	(void)index;
+	(void)timeout;
+
+	// blocking transfers wait for the submitted ones
+	while( !_i_in_flight.empty() )
+		wait();
+
+	auto end = _i_end_time();
+	if( end > std::chrono::steady_clock::now() )
+		std::this_thread::sleep_until( end );
+
+	return _i_handle_request( request_type, request, data, length );
+}
+
+int rd_emulator::interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ){
+
+	(void)endpoint;
+	(void)data;
+	(void)length;
+	(void)timeout;
+
+	if( transferred != NULL )
+		*transferred = 0;
+
+	_i_stats.invalid++;
+	return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int rd_emulator::submit_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	const uint8_t* data, uint16_t length, unsigned int timeout, completion_handler completed ){
+
+	(void)value;
+	(void)index;
+	(void)timeout;
+
+	rd_emulated_transfer transfer;
+	transfer.request_type = request_type;
+	transfer.request = request;
+	transfer.data.assign( data, data+length );
+	transfer.completed = completed;
+	transfer.end = _i_end_time();
+
+	_i_in_flight.push_back( std::move( transfer ) );
+
+	return 0;
+}
+
+void rd_emulator::wait(){
+
+	if( _i_in_flight.empty() )
+		return;
+
+	if( _i_in_flight.front().end > std::chrono::steady_clock::now() )
+		std::this_thread::sleep_until( _i_in_flight.front().end );
+
+	// complete all transfers that have ended, in order
+	auto now = std::chrono::steady_clock::now();
+	do{
+		rd_emulated_transfer transfer = std::move( _i_in_flight.front() );
+		_i_in_flight.pop_front();
+
+		int result = _i_handle_request( transfer.request_type, transfer.request, transfer.data.data(), transfer.data.size() );
+		transfer.completed( result );
+
+	} while( !_i_in_flight.empty() && _i_in_flight.front().end <= now );
+}
+
+void rd_emulator::set_memory( uint16_t address, const uint8_t* data, size_t length ){
+
+	length = std::min( length, _c_memory_size - address );
+	std::copy( data, data+length, _i_memory.begin() + address );
+}
+
+std::chrono::steady_clock::time_point rd_emulator::_i_end_time(){
+
+	_i_last_end = std::max( std::chrono::steady_clock::now() + _i_latency, _i_last_end + _i_interval );
+	return _i_last_end;
+}
+
+int rd_emulator::_i_handle_request( uint8_t request_type, uint8_t request, uint8_t* data, uint16_t length ){
+
+	// get report: the response to the last read request
+	if( request_type == 0xa1 && request == 0x01 ){
+
+		if( data != NULL ){
+			std::fill( data, data+length, 0 );
+			std::copy( _i_response.begin(), _i_response.begin() + std::min< size_t >( _i_response.size(), length ), data );
+		}
+
+		_i_response.clear();
+		return length;
+	}
+
+	// only set reports are supported, the mouse stalls other requests
+	if( request_type != 0x21 || request != 0x09 ){
+		_i_stats.invalid++;
+		return LIBUSB_ERROR_PIPE;
+	}
+
+	if( data == NULL || length < 8 ){
+		_i_stats.invalid++;
+		return length;
+	}
+
+	uint16_t address = data[2] | (data[3] << 8);
+	size_t count = data[4];
+
+	if( data[1] != 0xf2 && data[1] != 0xf3 ){
+		_i_stats.others++;
+		return length;
+	}
+
+	// the data has to fit in the report and in memory
+	if( 8 + count > length || address + count > _c_memory_size ){
+		_i_stats.invalid++;
+		return length;
+	}
+
+	if( data[1] == 0xf3 ){
+
+		std::copy( data+8, data+8+count, _i_memory.begin() + address );
+		_i_stats.writes++;
+		_i_stats.bytes_written += count;
+
+	} else{
+
+		_i_response.assign( data, data+length );
+		std::copy( _i_memory.begin() + address, _i_memory.begin() + address + count, _i_response.begin() + 8 );
+		_i_stats.reads++;
+	}
+
+	return length;
+}
@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_EMULATOR
+#define RD_EMULATOR
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "transport.h"
+
+/**
+ * This class emulates a mouse of the M908 protocol family (the wired models)
+ * in memory, for write → read round trips and benchmarks without a mouse
+ * (see rd_mouse::set_transport()).
+ *
+ * The mouse has a memory image of 64 KiB, all zero at first. The requests are
+ * HID set reports (0x21/0x09) of 16 or 64 bytes: byte 1 is the command, bytes
+ * 2-3 the address (little endian), byte 4 the number of bytes and the data
+ * starts at byte 8.
+ * - 0xf3 writes the data to memory (settings, macros and active profile)
+ * - 0xf2 requests data from memory, the next get report (0xa1/0x01) returns
+ *   the request with the data starting at byte 8
+ * - other commands (0xf5 at the start and end of a sequence, 0xf1 after
+ *   switching the profile) are accepted without changing memory
+ *
+ * Get reports without a pending request are answered with zeros. Interrupt
+ * transfers, used by the wireless models, are not supported.
+ */
+class rd_emulator : public rd_transport{
+
+	public:
+
+		/// Statistics of the emulated requests, see get_stats()
+		struct rd_emulator_stats{
+			/// write requests (0xf3)
+			unsigned int writes = 0;
+			/// read requests (0xf2)
+			unsigned int reads = 0;
+			/// other set reports, e.g. 0xf5 and 0xf1
+			unsigned int others = 0;
+			/// set reports that are too short or longer than the report, and unsupported transfers
+			unsigned int invalid = 0;
+			/// bytes written to memory
+			size_t bytes_written = 0;
+		};
+
+		rd_emulator() : _i_memory( _c_memory_size, 0 ) {}
+
+		int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) override;
+
+		/// Not supported, returns LIBUSB_ERROR_NOT_SUPPORTED
+		int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) override;
+
+		bool uses_device() override{ return false; }
+
+		bool supports_async() override{ return true; }
+
+		int submit_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			const uint8_t* data, uint16_t length, unsigned int timeout, completion_handler completed ) override;
+
+		void wait() override;
+
+		/** \brief Set the timing of the transfers in microseconds (default 0)
+		 * \arg latency time from the start until the end of a transfer
+		 * \arg interval minimum time between the ends of two transfers: the mouse handles one
+		 * request after another, asynchronous transfers overlap by latency - interval
+		 */
+		void set_latency( unsigned int latency, unsigned int interval = 0 ){
+			_i_latency = std::chrono::microseconds( latency );
+			_i_interval = std::chrono::microseconds( interval );
+		}
+
+		/// Get the memory image, 64 KiB
+		const std::vector< uint8_t >& get_memory(){ return _i_memory; }
+
+		/// Fill memory from address, e.g. with the data of a real mouse
+		void set_memory( uint16_t address, const uint8_t* data, size_t length );
+
+		/// Get the statistics since the last reset_stats()
+		const rd_emulator_stats& get_stats(){ return _i_stats; }
+
+		/// Reset the statistics
+		void reset_stats(){ _i_stats = rd_emulator_stats(); }
+
+	private:
+
+		/// Size of the memory image
+		static const size_t _c_memory_size = 0x10000;
+
+		/// A submitted asynchronous transfer
+		struct rd_emulated_transfer{
+			uint8_t request_type;
+			uint8_t request;
+			std::vector< uint8_t > data;
+			completion_handler completed;
+			std::chrono::steady_clock::time_point end;
+		};
+
+		std::vector< uint8_t > _i_memory;
+		/// response to the last read request, empty if none is pending
+		std::vector< uint8_t > _i_response;
+		rd_emulator_stats _i_stats;
+
+		std::chrono::steady_clock::duration _i_latency = std::chrono::steady_clock::duration::zero();
+		std::chrono::steady_clock::duration _i_interval = std::chrono::steady_clock::duration::zero();
+		/// end of the last transfer
+		std::chrono::steady_clock::time_point _i_last_end;
+		/// submitted transfers, in order
+		std::deque< rd_emulated_transfer > _i_in_flight;
+
+		/// End of a transfer that starts now, see set_latency()
+		std::chrono::steady_clock::time_point _i_end_time();
+
+		/** \brief Handle a request
+		 * \return the number of transferred bytes or a libusb error code
+		 */
+		int _i_handle_request( uint8_t request_type, uint8_t request, uint8_t* data, uint16_t length );
+};
+
+#endif
@@ -188,7 +188,18 @@ class mouse_generic : public rd_mouse{
 		
 		/// Checks if the mouse has the given vendor and product id
 		static bool has_vid_pid( uint16_t vid, uint16_t pid ){
-			return _c_all_vids.find(vid) != _c_all_vids.end() && _c_all_pids.find(pid) != _c_all_pids.end();
+			return std::find( _c_all_vids.begin(), _c_all_vids.end(), vid ) != _c_all_vids.end() &&
+				std::find( _c_all_pids.begin(), _c_all_pids.end(), pid ) != _c_all_pids.end();
+		}
+		
+		/// USB vendor and product ids of the mice with generic support, see rd_mouse::model_registry
+		static constexpr auto usb_ids(){
+			std::array< rd_usb_id, _c_all_vids.size() * _c_all_pids.size() > ids = {};
+			for( size_t i = 0; i < _c_all_vids.size(); i++ ){
+				for( size_t j = 0; j < _c_all_pids.size(); j++ )
+					ids[i*_c_all_pids.size() + j] = { _c_all_vids[i], _c_all_pids[j] };
+			}
+			return ids;
 		}
 		
 		/// Get mouse name
@@ -203,15 +214,35 @@ class mouse_generic : public rd_mouse{
 		int write_profile();
 		
 		/** \brief Write the settings (leds, button mapping, dpi, etc.) to the mouse
+		 * Supports verification, see rd_mouse::set_verify().
 		 * \return 0 if successful
 		 */
 		int write_settings();
 		
 		/** \brief Write a macro to the mouse
+		 * Supports verification, see rd_mouse::set_verify().
 		 * \return 0 if successful
 		 */
 		int write_macro( int macro_number );
 		
+		/** \brief Write the settings, macros and active profile changed by the setters since the last call
+		 * Only the changed rows of the settings and macros are sent, see rd_mouse::_i_write_changes().
+		 * \return 0 if successful
+		 */
+		int write_changes();
+		
+		/** \brief Write the dpi levels of a profile to the mouse, only the dpi rows of the settings are sent
+		 * Supports verification, see rd_mouse::set_verify().
+		 * \return 0 if successful
+		 */
+		int write_dpi( rd_profile profile );
+		
+		/** \brief Write the lightmode, color and speed of a profile to the mouse, only the led row of the settings is sent
+		 * Used by rd_led_stream, supports verification, see rd_mouse::set_verify().
+		 * \return 0 if successful
+		 */
+		int write_led( rd_profile profile );
+		
 		
 		
 		//helper functions
@@ -236,18 +267,31 @@ class mouse_generic : public rd_mouse{
 				
 		
 		//reader functions (get settings from the mouse)
+		/**
+		 * \brief Read the settings from the mouse once, without decoding them.
+		 * The snapshot can be passed to several of the functions below, the mouse is only read once.
+		 * \arg selection the sections to read, only the responses needed for them are requested
+		 * \return 0 if successful
+		 */
+		int read_snapshot( rd_device_snapshot& snapshot, const rd_read_selection& selection = rd_read_selection() );
 		/// Read the settings and print the raw data to output
 		int dump_settings( std::ostream& output );
+		/// Print the raw data of a snapshot to output
+		int dump_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This does not alter the internal settings of the mouse_generic class.
 		 */
 		int read_and_print_settings( std::ostream& output );
+		/// Print the configuration of a snapshot in .ini format to output, see read_and_print_settings( std::ostream& )
+		int read_and_print_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This updates the internal settings of the mouse_generic class.
 		 */
 		int read_settings();
+		/// Update the internal settings from a snapshot, see read_settings()
+		int read_settings( const rd_device_snapshot& snapshot );
 		
 		
 		
@@ -263,8 +307,32 @@ class mouse_generic : public rd_mouse{
 		static const std::string _c_name;
 
 		// usb ids for all mice with generic support
-		static std::set< uint16_t > _c_all_vids;
-		static std::set< uint16_t > _c_all_pids;
+		static constexpr std::array< uint16_t, 1 > _c_all_vids = {
+			0x04d9, // all known mice with generic support have the same VID
+		};
+		static constexpr std::array< uint16_t, 21 > _c_all_pids = {
+			0xfc02, // M901 Perdition
+			0xfc0f, // M990 Legend
+			0xfc2a, // M709 Tiger
+			0xfc30, // M711 Cobra (FPS)
+			0xfc38, // M607 Griffin
+			0xfc39, // M715 Dagger
+			0xfc2f, // M702-2 Phoenix 2
+			0xfc3f, // (?)
+			0xfc40, // M901 Perdition (3)
+			0xfc41, // M990 Legend Chroma/RGB
+			0xfc42, // M802 Titanoboa 2
+			0xfc49, // M910 Ranger
+			0xfc4c, // M909 Emperor
+			0xfc4d, // M908 Impact
+			0xfc4f, // M719 Invader
+			0xfc56, // M801 Mammoth (RGB?, there is an incompatible version with PID 0xfa56) 
+			0xfc58, // 2805 (?)
+			0xfc5c, // M721-Pro Lonewolf2
+			0xfc5e, // 2858 (?)
+			0xfc5f, // M998-RGB and M808-RGB (?)
+			0xfc61  // 2850 (?)
+		};
 		/// USB vendor id, needs to be explicitly set
 		uint16_t _c_mouse_vid = 0;
 		/// USB product id, needs to be explicitly set
@@ -22,6 +22,7 @@
 
 int mouse_generic::set_profile( rd_profile profile ){
 	_s_profile = profile;
+	_i_changes.profile = true;
 	return 0;
 }
 
@@ -32,17 +33,20 @@ int mouse_generic::set_scrollspeed( rd_profile profile, uint8_t speed ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_scrollspeeds[profile] = speed;
 	
 	return 0;
 }
 
 int mouse_generic::set_lightmode( rd_profile profile, rd_lightmode lightmode ){
+	_i_changes.profiles[profile] = true;
 	_s_lightmodes[profile] = lightmode;
 	return 0;
 }
 
 int mouse_generic::set_color( rd_profile profile, std::array<uint8_t, 3> color ){
+	_i_changes.profiles[profile] = true;
 	_s_colors[profile] = color;
 	return 0;
 }
@@ -54,6 +58,7 @@ int mouse_generic::set_brightness( rd_profile profile, uint8_t brightness ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_brightness_levels[profile] = brightness;
 	return 0;
 }
@@ -65,6 +70,7 @@ int mouse_generic::set_speed( rd_profile profile, uint8_t speed ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_speed_levels[profile] = speed;
 	return 0;
 }
@@ -76,6 +82,7 @@ int mouse_generic::set_dpi_enable( rd_profile profile, int level, bool enabled )
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_dpi_enabled[profile][level] = enabled;
 	
 	// check if at least one level enabled
@@ -111,6 +118,7 @@ int mouse_generic::set_dpi( rd_profile profile, int level, std::string dpi ){
 		if( b0 < _c_dpi_min || b0 > _c_dpi_max || b1 < _c_dpi_2_min || b1 > _c_dpi_2_max )
 			return 1;
 
+		_i_changes.profiles[profile] = true;
 		_s_dpi_levels[profile][level][0] = b0;
 		_s_dpi_levels[profile][level][1] = b1;
 		
@@ -131,12 +139,14 @@ int mouse_generic::set_dpi( rd_profile profile, int level, std::array<uint8_t, 2
 	if( dpi[0] < _c_dpi_min || dpi[0] > _c_dpi_max || dpi[1] < _c_dpi_2_min || dpi[1] > _c_dpi_2_max )
 		return 1;
 	
+	_i_changes.profiles[profile] = true;
 	_s_dpi_levels[profile][level][0] = dpi[0];
 	_s_dpi_levels[profile][level][1] = dpi[1];
 	return 0;
 }
 
 int mouse_generic::set_key_mapping( rd_profile profile, int key, std::array<uint8_t, 4> mapping ){
+	_i_changes.profiles[profile] = true;
 	_s_keymap_data[profile][key][0] = mapping[0];
 	_s_keymap_data[profile][key][1] = mapping[1];
 	_s_keymap_data[profile][key][2] = mapping[2];
@@ -154,6 +164,7 @@ int mouse_generic::set_key_mapping( rd_profile profile, int key, std::string map
 	int return_value = _i_encode_button_mapping( mapping, bytes );
 	
 	if( return_value == 0 ){
+		_i_changes.profiles[profile] = true;
 		_s_keymap_data[profile][key][0] = bytes[0];
 		_s_keymap_data[profile][key][1] = bytes[1];
 		_s_keymap_data[profile][key][2] = bytes[2];
@@ -164,6 +175,7 @@ int mouse_generic::set_key_mapping( rd_profile profile, int key, std::string map
 }
 
 int mouse_generic::set_report_rate( rd_profile profile, rd_report_rate report_rate ){
+	_i_changes.profiles[profile] = true;
 	_s_report_rates[profile] = report_rate;
 	return 0;
 }
@@ -183,6 +195,7 @@ int mouse_generic::set_macro( int macro_number, std::string file ){
 	
 	std::array< uint8_t, 256 > macro_bytes;
 	_i_encode_macro( macro_bytes, config_in, 8 );
+	_i_changes.macros[macro_number-1] = true;
 	std::copy( macro_bytes.begin()+8, macro_bytes.end(), _s_macro_data[macro_number-1].begin()+8 );
 	
 	config_in.close();
@@ -224,6 +237,8 @@ int mouse_generic::set_all_macros( std::string file ){
 		
 	}
 	
+	_i_changes.macros.fill( true );
+	
 	// encode and store all macros
 	for( int i = 0; i < 15; i++ ){
 		
@@ -22,21 +22,27 @@
 
 int mouse_generic::write_profile(){
 	
-	//prepare data
-	uint8_t buffer[6][16];
-	for( int i = 0; i < 6; i++ ){
-		std::copy(std::begin(_c_data_s_profile[i]), std::end(_c_data_s_profile[i]), std::begin(buffer[i]));
+	//prepare the packets of all profiles once, they only differ in the profile number
+	if( _i_profile_packets[0].empty() ){
+		
+		uint8_t buffer[6][16];
+		for( int i = 0; i < 6; i++ ){
+			std::copy(std::begin(_c_data_s_profile[i]), std::end(_c_data_s_profile[i]), std::begin(buffer[i]));
+		}
+		
+		for( int profile = 0; profile < 5; profile++ ){
+			
+			//modify buffer from default to include the profile
+			buffer[0][8] = profile;
+			
+			for( int i = 0; i < 6; i++ ){
+				_i_profile_packets[profile].emplace_back( 0x0302, buffer[i], 16 );
+			}
+		}
 	}
 	
-	//modify buffer from default to include specified profile
-	buffer[0][8] = _s_profile;
-	
 	//send data
-	for( int i = 0; i < 6; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
-	}
-	
-	return 0;
+	return _i_write_packets( _i_profile_packets[_s_profile] );
 }
 
 int mouse_generic::write_settings(){
@@ -110,20 +116,23 @@ int mouse_generic::write_settings(){
 		buffer1[14][2+(2*i)] = _i_encode_report_rate(_s_report_rates[i]);
 	
 	
+	std::vector< rd_packet > packets;
+	
 	//send data 1
 	for( int i = 0; i < rows1; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer1[i], 16 );
 	}
 	
-	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 64, 1000 );
+	//send data 2 (the scrollspeed can not be read back)
+	packets.emplace_back( 0x0302, buffer2, 64 );
+	packets.back().verify = false;
 	
 	//send data 3
 	for( int i = 0; i < rows3; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer3[i], 16 );
 	}
 	
-	return 0;
+	return _i_write_verified( packets );
 }
 
 int mouse_generic::write_macro( int macro_number ){
@@ -145,14 +154,80 @@ int mouse_generic::write_macro( int macro_number ){
 	uint8_t buffer3[16];
 	std::copy(std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3));
 	
+	std::vector< rd_packet > packets;
+	
 	//send data 1
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer1, 16 );
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+	packets.emplace_back( 0x0302, buffer2, 256 );
 	
 	//send data 3
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer3, 16 );
+	
+	return _i_write_verified( packets );
+}
+
+int mouse_generic::write_changes(){
+	return _i_write_changes(
+		[this](){ return write_settings(); },
+		[this]( int macro_number ){ return write_macro( macro_number ); },
+		[this](){ return write_profile(); }, true );
+}
+
+int mouse_generic::write_dpi( rd_profile profile ){
+	
+	//prepare data (rows 7-31 of data 3, 5 rows per dpi level with one row for each profile)
+	uint8_t buffer[5][16];
+	for( int i = 0; i < 5; i++ ){
+		std::copy(std::begin(_c_data_settings_3[7+(5*i)+profile]), std::end(_c_data_settings_3[7+(5*i)+profile]), std::begin(buffer[i]));
+	}
+	
+	//modify buffer to include the dpi levels of the profile
+	for( int i = 0; i < 5; i++ ){
+		buffer[i][8] = _s_dpi_enabled[profile][i];
+		buffer[i][9] = _s_dpi_levels[profile][i][0];
+		buffer[i][10] = _s_dpi_levels[profile][i][1];
+	}
+	
+	std::vector< rd_packet > packets;
+	
+	//send the dpi rows between the first and the last row of the settings
+	int rows3 = sizeof(_c_data_settings_3) / sizeof(_c_data_settings_3[0]);
+	packets.emplace_back( 0x0302, _c_data_settings_1[0], 16 );
+	for( int i = 0; i < 5; i++ ){
+		packets.emplace_back( 0x0302, buffer[i], 16 );
+	}
+	//the dpi rows are committed by row 32 of data 3 (02 f1 02 10), as in write_settings()
+	packets.emplace_back( 0x0302, _c_data_settings_3[32], 16 );
+	packets.emplace_back( 0x0302, _c_data_settings_3[rows3-1], 16 );
+	
+	return _i_write_settings_rows( packets );
+}
+
+int mouse_generic::write_led( rd_profile profile ){
+	
+	//prepare data (row 3+2*profile of data 1)
+	uint8_t buffer[16];
+	std::copy(std::begin(_c_data_settings_1[3+(2*profile)]), std::end(_c_data_settings_1[3+(2*profile)]), std::begin(buffer));
+	
+	//modify buffer to include the lightmode, color and speed of the profile
+	std::array<uint8_t, 2> lightmode_bytes = {0x01, 0x02}; // default value is lightmode_static, only relevent in case of an error
+	_i_encode_lightmode( _s_lightmodes[profile], lightmode_bytes );
+	buffer[8] = _s_colors[profile].at(0);
+	buffer[9] = _s_colors[profile].at(1);
+	buffer[10] = _s_colors[profile].at(2);
+	buffer[11] = lightmode_bytes.at(0);
+	buffer[12] = _s_speed_levels[profile];
+	buffer[13] = lightmode_bytes.at(1);
+	
+	std::vector< rd_packet > packets;
+	
+	//send the led row between the first and the last row of the settings
+	int rows3 = sizeof(_c_data_settings_3) / sizeof(_c_data_settings_3[0]);
+	packets.emplace_back( 0x0302, _c_data_settings_1[0], 16 );
+	packets.emplace_back( 0x0302, buffer, 16 );
+	packets.emplace_back( 0x0302, _c_data_settings_3[rows3-1], 16 );
 	
-	return 0;
+	return _i_write_settings_rows( packets );
 }
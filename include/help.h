@@ -27,8 +27,23 @@ Options:
 	Displays this message.
 -c --config=arg
 	Loads and applies settings from specified file.
+--diff
+	With -c: read the settings first and only send the changed packets.
+--verify
+	With -c, -m or --dpi: read back the written memory and re-send mismatching packets.
+--transfer-window=arg
+	Number of USB transfers kept in flight when writing (1-999, default 1).
+--transfer-timeout=ms
+	Timeout of each USB transfer in milliseconds (default 1000).
+--operation-timeout=ms
+	Time limit for reading or writing the settings, the profile or the macros in milliseconds (default none).
 -p --profile=arg
 	Sets currently active profile (1-5).
+--switch-latency=n
+	With -p: switch the profile n times and print the latency (p50, p99, histogram).
+--dpi=profile:dpi1,...
+	Sets the DPI levels of a profile (1-5) and only sends these, the levels
+	that are not given are disabled.
 -m --macro=arg
 	Selects macro file for sending.
 -n --number=arg
@@ -45,8 +60,39 @@ Options:
 	Read settings from the mouse and print configuration to the specified file ('-' = stdout).
 -D --dump=arg
 	Read settings from the mouse and dump the raw data to the specified file ('-' = stdout).
+--only=sections
+	With -R or -D: only read the specified sections (comma separated):
+	profile (active profile), battery, led, report_rate, dpi, buttons,
+	profile1-5, profile1-5.led|report_rate|dpi|buttons, macros, macros:1-15
 -M --model=arg
 	Specifies the mouse model (? for a list of valid models).
+--all
+	Perform the actions on all detected mice in parallel, results are printed per mouse.
+--watch
+	Prepare the packets for all actions once, then send them to every mouse that gets connected.
+--compile=file
+	Encode the packets for all actions without opening the mouse and write them to a packet image.
+--apply=file
+	Send the packets from a packet image (see --compile) to the mouse.
+--backup=file
+	Read the settings from the mouse and write the raw data to a binary snapshot.
+--restore=file
+	Send the settings from a snapshot (see --backup) to the mouse.
+--stream=fps
+	Read colors (rrggbb, one per line) from stdin and show them on the LED of the
+	profile given with -p (default 1), at most fps frames per second.
+--record=file
+	Perform the actions and write all USB transfers to a recording.
+--replay=file
+	Perform the actions without a mouse, with the transfers from a recording
+	(see --record), requires --model.
+--emulate
+	Perform the actions on a mouse emulated in memory instead of a real mouse,
+	requires --model (wired mice only).
+--daemon=socket
+	Keep the mouse open and perform the requests received on the specified socket.
+--socket=socket
+	Send all other options to the daemon listening on the specified socket.
 
 Examples:
 
@@ -58,4 +104,26 @@ Send all macros from example.ini
 	mouse_m908 -m example.ini
 Read and print the current config in .ini format
 	mouse_m908 -R -
+Read and print the active profile and the DPI levels of profile 2
+	mouse_m908 -R - --only=profile,profile2.dpi
+Switch profile 1 to two DPI levels without an .ini file
+	mouse_m908 --dpi=1:800,1600
+Show a color from a script on the LED of profile 2, up to 30 times per second
+	./colors.sh | mouse_m908 -p 2 --stream=30
+Compile example.ini for the M908 and apply it later
+	mouse_m908 --compile=m908.img -M 908 -c example.ini
+	mouse_m908 --apply=m908.img
+Copy the settings of one mouse to another
+	mouse_m908 --backup=mouse.snap
+	mouse_m908 --restore=mouse.snap
+Record reading the settings, then read them again without the mouse
+	mouse_m908 -R - --record=read.rec
+	mouse_m908 -R - --replay=read.rec -M 908
+Run a daemon with an emulated M908, e.g. to test scripts without a mouse
+	mouse_m908 --daemon=/tmp/mouse_m908.sock --emulate -M 908 &
+Start a daemon and switch to profile 2 through it
+	mouse_m908 --daemon=/tmp/mouse_m908.sock &
+	mouse_m908 --socket=/tmp/mouse_m908.sock -p 2
+Measure 1000 profile switches through the daemon
+	mouse_m908 --socket=/tmp/mouse_m908.sock -p 2 --switch-latency=1000
 )";
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+
+void rd_latency_histogram::add( double latency ){
+
+	if( !_i_latencies.empty() && latency < _i_latencies.back() )
+		_i_sorted = false;
+
+	_i_latencies.push_back( latency );
+}
+
+double rd_latency_histogram::percentile( double percent ){
+
+	if( _i_latencies.empty() )
+		return 0;
+
+	if( !_i_sorted ){
+		std::sort( _i_latencies.begin(), _i_latencies.end() );
+		_i_sorted = true;
+	}
+
+	size_t rank = (size_t)std::ceil( percent / 100 * _i_latencies.size() );
+	return _i_latencies[ std::clamp< size_t >( rank, 1, _i_latencies.size() ) - 1 ];
+}
+
+void rd_latency_histogram::print( const std::string& name, std::ostream& output ){
+
+	output << name << ": " << size() << " measured";
+	if( _i_latencies.empty() ){
+		output << ".\n";
+		return;
+	}
+
+	std::ios_base::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+	
+	output << std::fixed << std::setprecision( 3 )
+		<< ", p50 " << percentile( 50 ) / 1000 << " ms"
+		<< ", p99 " << percentile( 99 ) / 1000 << " ms"
+		<< ", maximum " << percentile( 100 ) / 1000 << " ms\n";
+
+	// count the latencies per bucket, the last bucket has no upper bound
+	std::array< size_t, _c_buckets > counts = {};
+	for( double latency : _i_latencies ){
+		int bucket = 0;
+		for( double bound = _c_first_bucket; bucket < _c_buckets-1 && latency >= bound; bound *= 2 )
+			bucket++;
+		counts[bucket]++;
+	}
+
+	// only print the buckets from the first to the last non-empty one
+	int first = 0, last = _c_buckets-1;
+	while( counts[first] == 0 )
+		first++;
+	while( counts[last] == 0 )
+		last--;
+
+	size_t largest = *std::max_element( counts.begin(), counts.end() );
+	for( int i = first; i <= last; i++ ){
+
+		double bound = _c_first_bucket * std::pow( 2, i ) / 1000;
+		if( i < _c_buckets-1 )
+			output << "  < " << std::setw( 8 ) << bound << " ms ";
+		else
+			output << "  >=" << std::setw( 8 ) << bound / 2 << " ms ";
+
+		output << std::setw( 8 ) << counts[i] << " " << std::string( (counts[i] * 40 + largest - 1) / largest, '#' ) << "\n";
+	}
+
+	output.flags( flags );
+	output.precision( precision );
+}
@@ -0,0 +1,64 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_LATENCY_HISTOGRAM
+#define RD_LATENCY_HISTOGRAM
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * This class collects latencies (e.g. of profile switches, see mouse_m908
+ * --switch-latency) and reports percentiles and a histogram.
+ *
+ * The histogram has one bucket per power of two milliseconds, from
+ * below 0.125 ms up to 1 s and more.
+ */
+class rd_latency_histogram{
+
+	public:
+
+		/// Add a latency in microseconds
+		void add( double latency );
+
+		/// Number of latencies
+		size_t size() const { return _i_latencies.size(); }
+
+		/** \brief Get a percentile (nearest rank) in microseconds
+		 * \arg percent 0-100, e.g. 50 for the median
+		 * \return 0 if no latency has been added
+		 */
+		double percentile( double percent );
+
+		/// Print the number of latencies, p50, p99, the maximum and the histogram, name describes a latency
+		void print( const std::string& name, std::ostream& output );
+
+	private:
+
+		/// upper bound of the first bucket in microseconds, each bucket doubles it
+		static constexpr double _c_first_bucket = 125;
+		static const int _c_buckets = 15;
+
+		std::vector< double > _i_latencies;
+		/// whether _i_latencies is sorted
+		bool _i_sorted = true;
+};
+
+#endif
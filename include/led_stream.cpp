@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "led_stream.h"
+
+#include <charconv>
+#include <thread>
+
+rd_led_stream::rd_led_stream( double frame_rate ){
+
+	if( frame_rate > 0 )
+		_i_interval = std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< double >( 1.0 / frame_rate ) );
+	else
+		_i_interval = std::chrono::steady_clock::duration::zero();
+}
+
+void rd_led_stream::push( const std::array< uint8_t, 3 >& color ){
+
+	std::lock_guard< std::mutex > lock( _i_mutex );
+
+	if( _i_pending )
+		_i_stats.dropped++;
+
+	_i_pending = rd_led_frame{ color, std::chrono::steady_clock::now() };
+	_i_condition.notify_one();
+}
+
+void rd_led_stream::close(){
+
+	std::lock_guard< std::mutex > lock( _i_mutex );
+
+	_i_closed = true;
+	_i_condition.notify_one();
+}
+
+rd_led_stream::rd_stream_stats rd_led_stream::get_stats(){
+
+	std::lock_guard< std::mutex > lock( _i_mutex );
+	return _i_stats;
+}
+
+bool rd_led_stream::_i_next_frame( rd_led_frame& frame ){
+
+	std::unique_lock< std::mutex > lock( _i_mutex );
+
+	_i_condition.wait( lock, [this](){ return _i_pending || _i_closed; } );
+	if( !_i_pending )
+		return false;
+
+	// keep the frame rate, newer frames replace the pending frame in the meantime
+	if( std::chrono::steady_clock::now() < _i_next_slot ){
+		lock.unlock();
+		std::this_thread::sleep_until( _i_next_slot );
+		lock.lock();
+	}
+
+	frame = *_i_pending;
+	_i_pending.reset();
+
+	_i_next_slot = std::max( std::chrono::steady_clock::now(), _i_next_slot ) + _i_interval;
+
+	return true;
+}
+
+void rd_led_stream::_i_frame_sent( const rd_led_frame& frame, bool successful ){
+
+	auto now = std::chrono::steady_clock::now();
+	std::lock_guard< std::mutex > lock( _i_mutex );
+
+	if( !successful ){
+		_i_stats.failed++;
+		return;
+	}
+
+	if( _i_stats.frames == 0 )
+		_i_first_frame = now;
+
+	double latency = std::chrono::duration< double, std::micro >( now - frame.time ).count();
+
+	_i_stats.frames++;
+	_i_stats.latency_total += latency;
+	_i_stats.latency_max = std::max( _i_stats.latency_max, latency );
+	_i_stats.duration = std::chrono::duration< double, std::micro >( now - _i_first_frame ).count();
+}
+
+int rd_led_stream::parse_color( const std::string& text, std::array< uint8_t, 3 >& color ){
+
+	if( text.length() != 6 )
+		return 1;
+
+	for( size_t i = 0; i < 3; i++ ){
+
+		const char* first = text.data() + 2*i;
+		auto result = std::from_chars( first, first+2, color[i], 16 );
+
+		if( result.ec != std::errc() || result.ptr != first+2 )
+			return 1;
+	}
+
+	return 0;
+}
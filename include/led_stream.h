@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_LED_STREAM
+#define RD_LED_STREAM
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "rd_mouse.h"
+
+/**
+ * This class streams LED colors to a mouse at a fixed frame rate, for lighting
+ * effects driven by the host (notifications, audio visualizers, etc.).
+ *
+ * Frames are added with push() from any thread and sent by run(), which only
+ * sends the LED row of the profile (see the write_led() functions of the models).
+ * Only the newest frame is kept: frames pushed faster than they can be sent
+ * are dropped, so the mouse always shows the latest color.
+ */
+class rd_led_stream{
+
+	public:
+
+		/// Statistics of a stream, see get_stats()
+		struct rd_stream_stats{
+			/// frames sent to the mouse
+			unsigned int frames = 0;
+			/// frames replaced by a newer frame before they were sent
+			unsigned int dropped = 0;
+			/// frames that could not be sent
+			unsigned int failed = 0;
+			/// time from push() until the frame was sent, in microseconds
+			double latency_total = 0, latency_max = 0;
+			/// time from the first to the last sent frame, in microseconds
+			double duration = 0;
+		};
+
+		/** \brief Create a stream
+		 * \arg frame_rate maximum number of frames per second, 0 = as fast as possible
+		 */
+		rd_led_stream( double frame_rate );
+
+		/// Add a frame, replaces the frame that has not been sent yet
+		void push( const std::array< uint8_t, 3 >& color );
+
+		/// End the stream, run() returns after sending the last frame
+		void close();
+
+		/** \brief Prepare a mouse for streaming to the LED of a profile
+		 * Switches the LED to lightmode static, with the current color of the mouse object.
+		 * Throws std::string if the mouse does not support write_led().
+		 * \return 0 if successful
+		 */
+		template< typename T > static int prepare( T& mouse, rd_mouse::rd_profile profile );
+
+		/// Send the frames to the LED of a profile until close() has been called, see prepare()
+		template< typename T > void run( T& mouse, rd_mouse::rd_profile profile );
+
+		/// Get the statistics of the stream
+		rd_stream_stats get_stats();
+
+		/** \brief Parse a color as rrggbb (hexadecimal)
+		 * \return 0 if successful
+		 */
+		static int parse_color( const std::string& text, std::array< uint8_t, 3 >& color );
+
+	private:
+
+		/// A color and the time it was pushed
+		struct rd_led_frame{
+			std::array< uint8_t, 3 > color;
+			std::chrono::steady_clock::time_point time;
+		};
+
+		/// time between two frames
+		std::chrono::steady_clock::duration _i_interval;
+		/// earliest time the next frame may be sent
+		std::chrono::steady_clock::time_point _i_next_slot;
+		/// time the first frame was sent
+		std::chrono::steady_clock::time_point _i_first_frame;
+
+		std::mutex _i_mutex;
+		std::condition_variable _i_condition;
+		/// the newest frame that has not been sent
+		std::optional< rd_led_frame > _i_pending;
+		/// set by close()
+		bool _i_closed = false;
+		rd_stream_stats _i_stats;
+
+		/** \brief Wait for the next frame and its time slot
+		 * \return false if the stream has been closed and all frames have been sent
+		 */
+		bool _i_next_frame( rd_led_frame& frame );
+
+		/// Update the statistics after sending a frame
+		void _i_frame_sent( const rd_led_frame& frame, bool successful );
+};
+
+template< typename T > int rd_led_stream::prepare( T& mouse, rd_mouse::rd_profile profile ){
+
+	mouse.set_lightmode( profile, rd_mouse::lightmode_static );
+	mouse.begin_operation();
+	return mouse.write_led( profile );
+}
+
+template< typename T > void rd_led_stream::run( T& mouse, rd_mouse::rd_profile profile ){
+
+	rd_led_frame frame;
+	while( _i_next_frame( frame ) ){
+		mouse.set_color( profile, frame.color );
+		mouse.begin_operation();
+		_i_frame_sent( frame, mouse.write_led( profile ) == 0 );
+	}
+}
+
+#endif
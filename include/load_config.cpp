@@ -18,58 +18,118 @@
 
 #include "load_config.h"
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 // read and parse ini file
-int simple_ini_parser::read_ini( std::string path ){
+int simple_ini_parser::read_ini( const std::string& path ){
 	
-	// open file
-	std::ifstream inifile;
-	inifile.open( path );
+	// read the whole file
+	std::ifstream inifile( path, std::ios::binary );
 	
 	if( !inifile.is_open() )
 		return 1;
 	
-	// go through each line
-	std::string line, current_section = "";
+	std::string content( (std::istreambuf_iterator<char>(inifile)), std::istreambuf_iterator<char>() );
+	inifile.close();
+	
+	// position of a key and its value in buffer
+	struct entry{
+		size_t key, key_length, value, value_length;
+	};
+	
+	std::vector< entry > entries;
+	std::string buffer, line, current_section = "";
+	buffer.reserve( content.size() );
 	
-	while( std::getline( inifile, line ) ){
+	// go through each line
+	size_t line_start = 0;
+	while( line_start < content.size() ){
+		
+		size_t line_end = content.find( '\n', line_start );
+		if( line_end == std::string::npos )
+			line_end = content.size();
+		
+		size_t line_length = line_end - line_start;
+		char first = content[line_start];
+		line_start = line_end + 1;
 		
 		// empty line ?
-		if( line.length() == 0 )
+		if( line_length == 0 )
 			continue;
 		
 		// comment ?
-		if( line[0] == ';' || line[0] == '#' )
+		if( first == ';' || first == '#' )
 			continue;
 		
-		// remove whitespace
-		line = std::regex_replace( line, std::regex("[[:space:]]"), "" );
+		// remove whitespace, lines with other non-printable characters are ignored
+		line.clear();
+		bool printable = true;
+		for( size_t i = line_end - line_length; i < line_end; i++ ){
+			
+			char c = content[i];
+			if( c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r' )
+				continue;
+			if( c < 0x20 || c > 0x7e )
+				printable = false;
+			
+			line.push_back( c );
+		}
+		
+		if( !printable || line.empty() )
+			continue;
 		
 		// section header?
-		if( std::regex_match( line, std::regex("\\[[[:print:]]+\\]") ) ){
-			current_section = std::regex_replace( line, std::regex("[\\[\\]]"), "" ) + ".";
+		if( line.length() > 2 && line.front() == '[' && line.back() == ']' ){
+			current_section.clear();
+			std::copy_if( line.begin(), line.end(), std::back_inserter( current_section ),
+				[]( char c ){ return c != '[' && c != ']'; } );
+			current_section += ".";
 			continue;
 		}
 		
-		// key=value ?
-		if( std::regex_match( line, std::regex("[[:print:]]+=[[:print:]]+") ) ){
-			_ini_values.emplace( current_section + std::regex_replace( line, std::regex("=[[:print:]]+"), "" ),
-				std::regex_replace( line, std::regex("[[:print:]]+="), "" ) );
-		}
+		// key=value ? (requires an '=' with at least one character on both sides)
+		size_t separator = line.find( '=', 1 );
+		if( separator == std::string::npos || separator > line.length() - 2 )
+			continue;
+		
+		// the key ends at the first '=' that is not the last character,
+		// the value starts after the last '=' that is not the first character
+		size_t key_end = ( line[0] == '=' ) ? 0 : separator;
+		size_t value_start = line.rfind( '=' ) + 1;
+		
+		entry e;
+		e.key = buffer.size();
+		e.key_length = current_section.length() + key_end;
+		buffer += current_section;
+		buffer.append( line, 0, key_end );
 		
+		e.value = buffer.size();
+		e.value_length = line.length() - value_start;
+		buffer.append( line, value_start, std::string::npos );
+		
+		entries.push_back( e );
 	}
 	
-	// close file
-	inifile.close();
+	// views into the buffer are created after it is complete, the first value of a key is kept
+	const std::string& stored = _ini_buffers.emplace_back( std::move( buffer ) );
+	
+	for( auto& e : entries ){
+		_ini_values.emplace( std::string_view( stored.data() + e.key, e.key_length ),
+			std::string_view( stored.data() + e.value, e.value_length ) );
+	}
 	
 	return 0;
 }
 
 // get values
-std::string simple_ini_parser::get( std::string key, std::string default_value ){
+std::string simple_ini_parser::get( const std::string& key, const std::string& default_value ){
 	
 	// check if key exists
-	if( _ini_values.find( key ) != _ini_values.end() ){
-		return _ini_values.at( key );
+	auto value = _ini_values.find( key );
+	if( value != _ini_values.end() ){
+		return std::string( value->second );
 	} else{
 		return default_value;
 	}
@@ -79,7 +139,10 @@ std::string simple_ini_parser::get( std::string key, std::string default_value )
 // print all key-value pairs
 int simple_ini_parser::print_all(){
 	
-	for( auto i : _ini_values ){
+	std::vector< std::pair< std::string_view, std::string_view > > sorted( _ini_values.begin(), _ini_values.end() );
+	std::sort( sorted.begin(), sorted.end() );
+	
+	for( auto& i : sorted ){
 		std::cout << i.first << "=" << i.second << "\n";
 	}
 	
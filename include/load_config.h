@@ -21,9 +21,10 @@
 
 #include <iostream>
 #include <fstream>
-#include <regex>
+#include <list>
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
 
 /**
  * This is a standalone .ini parser, written to replace boost property
@@ -31,32 +32,40 @@
  * purpose replacement, however there is nothing preventing that except
  * the very limited amount of features. 
  * 
+ * Each file is read into one buffer holding the normalized keys
+ * ("section.key") and values, the lookup table stores views into
+ * these buffers.
  */
 class simple_ini_parser{
 	
 	private:
 	
-	/// Stores the key-value pairs
-	std::map< std::string, std::string > _ini_values;
+	/// Stores the normalized keys and values of each file read by read_ini()
+	std::list< std::string > _ini_buffers;
+	
+	/// Stores the key-value pairs, both are views into _ini_buffers
+	std::unordered_map< std::string_view, std::string_view > _ini_values;
 	
 	public:
 	
 	/** 
 	 * Read the specified .ini file. The already existing key-value
-	 * pairs do not get cleared, only overwritten.
+	 * pairs do not get cleared or overwritten, the first value of a key is kept.
+	 * 
+	 * Lines starting with ; or # are comments, all whitespace is ignored.
 	 * \return 0 if succesful
 	 */
-	int read_ini( std::string path );
+	int read_ini( const std::string& path );
 	
 	/**
 	 * Get the value of the specified key.
 	 * \return The value of the specified key, or the specified default
 	 * value if the key is unkwnown
 	 */
-	std::string get( std::string key, std::string default_value );
+	std::string get( const std::string& key, const std::string& default_value );
 	
 	/**
-	 * Print all key-value pairs to stdout.
+	 * Print all key-value pairs to stdout, sorted by key.
 	 */
 	int print_all();
 };
@@ -137,22 +137,8 @@ int mouse_m607::print_settings( std::ostream& output ){
 		}
 	}
 	
-	// macros
-	output << "\n# Macros\n";
-	for( int i = 0; i < 15; i++ ){
-		
-		// is macro not defined ?
-		if( _s_macro_data[i][8] == 0 && _s_macro_data[i][9] == 0 && _s_macro_data[i][10] == 0 )
-			continue;
-		
-		// _i_decode_macros takes a vector as argument, copy array to vector
-		std::vector< uint8_t > macro_bytes( _s_macro_data[i].begin(), _s_macro_data[i].end() );
-		
-		// print macro (macro data starts at byte 8)
-		output << "\n;## macro" << i+1 << "\n";
-		_i_decode_macro( macro_bytes, output, ";# ", 8 );
-		
-	}
+	// macros (macro data starts at byte 8)
+	_i_decode_macros( _s_macro_data, output, 8 );
 	
 	return 0;
 }
@@ -24,13 +24,6 @@
 
 const std::string mouse_m686::_c_name = "686";
 
-// usb device vars
-const uint16_t mouse_m686::_c_mouse_vid = 0x25a7;
-std::set< uint16_t > mouse_m686::_c_all_pids = {
-	0xfa34, // wireless connection
-	0xfa35  // wired connection
-};
-
 // Names of the physical buttons
 std::map< int, std::string > mouse_m686::_c_button_names = {
 	{ 0, "button_left" },
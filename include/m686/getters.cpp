@@ -118,16 +118,12 @@ int mouse_m686::get_macro_raw( int number, std::array<uint8_t, 256>& macro ){
 
 int mouse_m686::get_macro( int number, std::string& macro ){
 	
-	std::stringstream output;
-	
 	// macro undefined?
 	if( _s_macro_data[number-1][8] == 0 && _s_macro_data[number-1][9] == 0 && _s_macro_data[number-1][10] == 0 )
 		return 0;
 	
-	std::vector< uint8_t > macro_bytes;
-	std::copy( _s_macro_data[number-1].begin(), _s_macro_data[number-1].end(), std::back_inserter(macro_bytes) );
-	
-	_i_decode_macro( macro_bytes, output, "", 8 );
-	macro = output.str();
+	// macro data starts at byte 8
+	macro.clear();
+	_i_decode_macro( _s_macro_data[number-1].data() + 8, _s_macro_data[number-1].size() - 8, macro, "" );
 	return 0;
 }
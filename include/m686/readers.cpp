@@ -20,35 +20,93 @@
 
 //reader functions (get settings from mouse)
 
-int mouse_m686::dump_settings( std::ostream& output ){
+int mouse_m686::read_snapshot( rd_device_snapshot& snapshot, const rd_read_selection& selection ){
 	int ret = 0;
 
 	size_t rows = sizeof(_c_data_read) / sizeof(_c_data_read[0]);
-	uint8_t buffer_in[17];
+	snapshot = rd_device_snapshot();
+	snapshot.add_part( rows, 17 );
+	snapshot.selection = selection;
+
+	// only the responses needed for the selection are requested,
+	// only the active profile (profile1) can be read
+	std::vector< bool > wanted( rows, selection.everything() );
+	auto want = [&wanted]( size_t first, size_t last ){
+		for( size_t i = first; i <= last && i < wanted.size(); i++ )
+			wanted[i] = true;
+	};
+	if( selection.battery )
+		want( 68, 68 );
+	if( selection.report_rate[0] )
+		want( 4, 4 );
+	if( selection.dpi[0] ){
+		want( 2, 2 );
+		want( 5, 7 );
+	}
+	if( selection.buttons[0] )
+		want( 13, 19 );
+	snapshot.requested = { wanted };
+
 	for( size_t i = 0; i < rows; i++ ){
-		ret += libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0308, 0x0001, _c_data_read[i], 17, 1000 );
-		ret += libusb_interrupt_transfer( _i_handle, 0x82, buffer_in, 17, NULL, 1000 );
+		if( !wanted[i] )
+			continue;
+		if( _i_control_transfer( 0x21, 0x09, 0x0308, 0x0001, _c_data_read[i], 17 ) < 0 )
+			ret++;
+		if( _i_interrupt_transfer( 0x82, snapshot.parts[0][i].data(), 17, &snapshot.lengths[0][i] ) < 0 )
+			ret++;
+	}
+
+	return ret;
+}
+
+int mouse_m686::dump_settings( std::ostream& output ){
+
+	rd_device_snapshot snapshot;
+	int ret = read_snapshot( snapshot );
+
+	dump_settings( snapshot, output );
+
+	return ret;
+}
+
+int mouse_m686::dump_settings( const rd_device_snapshot& snapshot, std::ostream& output ){
+
+	if( snapshot.parts.size() != 1 )
+		return 1;
+
+	for( size_t i = 0; i < snapshot.parts[0].size(); i++ ){
+
+		// skip responses that were not requested
+		if( !snapshot.requested.empty() && !snapshot.requested[0][i] )
+			continue;
 
 		for( size_t j = 0; j < 17; j++ )
-			output << std::hex << std::setw(2) << std::setfill('0') << (int)buffer_in[j] << " ";
+			output << std::hex << std::setw(2) << std::setfill('0') << (int)snapshot.parts[0][i][j] << " ";
 		output << "\n";
 	}
 
 	output << std::dec << std::setw(0) << std::setfill(' ');
 
-	return ret;
+	return 0;
 }
 
 int mouse_m686::read_and_print_settings( std::ostream& output ){
-	int ret = 0;
 
-	// read settings
-	size_t rows = sizeof(_c_data_read) / sizeof(_c_data_read[0]);
-	uint8_t buffer_in[rows][17];
-	for( size_t i = 0; i < rows; i++ ){
-		ret += libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0308, 0x0001, _c_data_read[i], 17, 1000 );
-		ret += libusb_interrupt_transfer( _i_handle, 0x82, buffer_in[i], 17, NULL, 1000 );
-	}
+	rd_device_snapshot snapshot;
+	int ret = read_snapshot( snapshot );
+
+	read_and_print_settings( snapshot, output );
+
+	return ret;
+}
+
+int mouse_m686::read_and_print_settings( const rd_device_snapshot& snapshot, std::ostream& output ){
+
+	// responses of the read sequence
+	if( snapshot.parts.size() != 1 )
+		return 1;
+
+	const auto& buffer_in = snapshot.parts[0];
 
 	// decode and print the settings
 	output
@@ -57,66 +115,84 @@ int mouse_m686::read_and_print_settings( std::ostream& output ){
 		<< "# Note: this feature is incomplete for the m686.\n\n";
 	
 	// battery level
-	output << "# Battery level: ";
-	if(buffer_in[68][6] <= 10)
-		output << (int)(buffer_in[68][6] * 10) << " %\n\n";
-	else
-		output << "unkown, please report as a bug (" << (int)buffer_in[68][6] << ")\n\n";
+	if( snapshot.selection.battery ){
+		output << "# Battery level: ";
+		if(buffer_in[68][6] <= 10)
+			output << (int)(buffer_in[68][6] * 10) << " %\n\n";
+		else
+			output << "unkown, please report as a bug (" << (int)buffer_in[68][6] << ")\n\n";
+	}
+
+	// only the active profile was read
+	if( !snapshot.selection.profile( 0 ) )
+		return 0;
 
 	output
 		<< "# The m686 has two profiles that can be switched using the 'mode switch' button on the bottom of the mouse.\n"
 	 	<< "# Reading the settings can only be done for the active profile, therefore only profile1 is used in this config.\n"
 		<< "[profile1]\n\n";
 
-	output << "report_rate=";
-	switch(buffer_in[4][6]){
-		case 0x1: output << "1000\n"; break;
-		case 0x2: output << "500\n"; break;
-		case 0x4: output << "250\n"; break;
-		case 0x8: output << "125\n"; break;
-		default: output << "unknown\n"; break;
+	if( snapshot.selection.report_rate[0] ){
+		output << "report_rate=";
+		switch(buffer_in[4][6]){
+			case 0x1: output << "1000\n"; break;
+			case 0x2: output << "500\n"; break;
+			case 0x4: output << "250\n"; break;
+			case 0x8: output << "125\n"; break;
+			default: output << "unknown\n"; break;
+		}
 	}
 
 	// DPI
-	output << "\n# DPI settings\n";
-	output << "# Currently active DPI level: " << (int)(buffer_in[2][6] + 1) << "\n";
-	std::string dpi = "";
-	_i_decode_dpi({buffer_in[5][8], buffer_in[5][9], buffer_in[5][11]}, dpi);
-	output << "dpi1=" << dpi << "\n";
-	_i_decode_dpi({buffer_in[5][12], buffer_in[5][13], buffer_in[5][15]}, dpi);
-	output << "dpi2=" << dpi << "\n";
-	_i_decode_dpi({buffer_in[6][6], buffer_in[6][7], buffer_in[6][9]}, dpi);
-	output << "dpi3=" << dpi << "\n";
-	_i_decode_dpi({buffer_in[6][10], buffer_in[6][11], buffer_in[6][13]}, dpi);
-	output << "dpi4=" << dpi << "\n";
-	_i_decode_dpi({buffer_in[6][14], buffer_in[6][15], buffer_in[7][7]}, dpi);
-	output << "dpi5=" << dpi << "\n";
+	if( snapshot.selection.dpi[0] ){
+		output << "\n# DPI settings\n";
+		output << "# Currently active DPI level: " << (int)(buffer_in[2][6] + 1) << "\n";
+		std::string dpi = "";
+		_i_decode_dpi({buffer_in[5][8], buffer_in[5][9], buffer_in[5][11]}, dpi);
+		output << "dpi1=" << dpi << "\n";
+		_i_decode_dpi({buffer_in[5][12], buffer_in[5][13], buffer_in[5][15]}, dpi);
+		output << "dpi2=" << dpi << "\n";
+		_i_decode_dpi({buffer_in[6][6], buffer_in[6][7], buffer_in[6][9]}, dpi);
+		output << "dpi3=" << dpi << "\n";
+		_i_decode_dpi({buffer_in[6][10], buffer_in[6][11], buffer_in[6][13]}, dpi);
+		output << "dpi4=" << dpi << "\n";
+		_i_decode_dpi({buffer_in[6][14], buffer_in[6][15], buffer_in[7][7]}, dpi);
+		output << "dpi5=" << dpi << "\n";
+	}
 
 	// button mapping
-	output << "\n# Button mapping\n";
-	std::string mapping = "";
-
-	_i_decode_button_mapping({buffer_in[13][12], buffer_in[13][13], buffer_in[13][14], buffer_in[13][15]}, mapping);
-	output << "button_left=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[14][6], buffer_in[14][7], buffer_in[14][8], buffer_in[14][9]}, mapping);
-	output << "button_right=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[14][10], buffer_in[14][11], buffer_in[14][12], buffer_in[14][13]}, mapping);
-	output << "button_middle=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[15][8], buffer_in[15][9], buffer_in[15][10], buffer_in[15][11]}, mapping);
-	output << "button_side_1=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[16][14], buffer_in[16][15], buffer_in[17][6], buffer_in[17][7]}, mapping);
-	output << "button_side_2=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[15][12], buffer_in[15][13], buffer_in[15][14], buffer_in[15][15]}, mapping);
-	output << "button_side_3=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[17][12], buffer_in[17][13], buffer_in[17][14], buffer_in[17][15]}, mapping);
-	output << "button_dpi_up=" << mapping << "\n";
-	_i_decode_button_mapping({buffer_in[18][6], buffer_in[18][7], buffer_in[18][8], buffer_in[18][9]}, mapping);
-	output << "button_dpi_down=" << mapping << "\n";
+	if( snapshot.selection.buttons[0] ){
+		output << "\n# Button mapping\n";
+		std::string mapping = "";
+
+		_i_decode_button_mapping({buffer_in[13][12], buffer_in[13][13], buffer_in[13][14], buffer_in[13][15]}, mapping);
+		output << "button_left=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[14][6], buffer_in[14][7], buffer_in[14][8], buffer_in[14][9]}, mapping);
+		output << "button_right=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[14][10], buffer_in[14][11], buffer_in[14][12], buffer_in[14][13]}, mapping);
+		output << "button_middle=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[15][8], buffer_in[15][9], buffer_in[15][10], buffer_in[15][11]}, mapping);
+		output << "button_side_1=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[16][14], buffer_in[16][15], buffer_in[17][6], buffer_in[17][7]}, mapping);
+		output << "button_side_2=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[15][12], buffer_in[15][13], buffer_in[15][14], buffer_in[15][15]}, mapping);
+		output << "button_side_3=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[17][12], buffer_in[17][13], buffer_in[17][14], buffer_in[17][15]}, mapping);
+		output << "button_dpi_up=" << mapping << "\n";
+		_i_decode_button_mapping({buffer_in[18][6], buffer_in[18][7], buffer_in[18][8], buffer_in[18][9]}, mapping);
+		output << "button_dpi_down=" << mapping << "\n";
+	}
 
-	return ret;
+	return 0;
 }
 
 int mouse_m686::read_settings(){
 	// currently not implemented
 	return 1;
 }
+
+int mouse_m686::read_settings( const rd_device_snapshot& snapshot ){
+	// currently not implemented
+	(void)snapshot;
+	return 1;
+}
@@ -22,6 +22,7 @@
 
 int mouse_m686::set_profile( rd_profile profile ){
 	_s_profile = profile;
+	_i_changes.profile = true;
 	return 0;
 }
 
@@ -32,6 +33,7 @@ int mouse_m686::set_scrollspeed( rd_profile profile, uint8_t speed ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_scrollspeeds[rd_profile_to_m686_profile(profile)] = speed;
 	
 	return 0;
@@ -46,11 +48,13 @@ int mouse_m686::set_lightmode( rd_profile profile, rd_lightmode lightmode ){
 		default: l = mouse_m686::m686_lightmode::lightmode_static; break;
 	}
 
+	_i_changes.profiles[profile] = true;
 	_s_lightmodes[rd_profile_to_m686_profile(profile)] = l;
 	return 0;
 }
 
 int mouse_m686::set_color( rd_profile profile, std::array<uint8_t, 3> color ){
+	_i_changes.profiles[profile] = true;
 	_s_colors[rd_profile_to_m686_profile(profile)] = color;
 	return 0;
 }
@@ -62,6 +66,7 @@ int mouse_m686::set_brightness( rd_profile profile, uint8_t brightness ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_brightness_levels[rd_profile_to_m686_profile(profile)] = brightness;
 	return 0;
 }
@@ -73,6 +78,7 @@ int mouse_m686::set_speed( rd_profile profile, uint8_t speed ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_speed_levels[rd_profile_to_m686_profile(profile)] = speed;
 	return 0;
 }
@@ -84,6 +90,7 @@ int mouse_m686::set_dpi_enable( rd_profile profile, int level, bool enabled ){
 		return 1;
 	}
 	
+	_i_changes.profiles[profile] = true;
 	_s_dpi_enabled[rd_profile_to_m686_profile(profile)][level] = enabled;
 	
 	// check if at least one level enabled
@@ -123,6 +130,7 @@ int mouse_m686::set_dpi( rd_profile profile, int level, std::string dpi ){
 		//if( b0 < _c_dpi_min || b0 > _c_dpi_max || b1 < _c_dpi_2_min || b1 > _c_dpi_2_max )
 		//	return 1;
 
+		_i_changes.profiles[profile] = true;
 		_s_dpi_levels[profile][level][0] = b0;
 		_s_dpi_levels[profile][level][1] = b1;
 		
@@ -136,6 +144,7 @@ int mouse_m686::set_dpi( rd_profile profile, int level, std::string dpi ){
 		
 		if( _c_dpi_codes.find( std::stoi(dpi) ) != _c_dpi_codes.end() ){
 
+			_i_changes.profiles[profile] = true;
 			_s_dpi_levels[rd_profile_to_m686_profile(profile)][level] = _c_dpi_codes.at( std::stoi(dpi) );
 			return 0;
 		}
@@ -153,11 +162,13 @@ int mouse_m686::set_dpi( rd_profile profile, int level, std::array<uint8_t, 3> d
 	// current assumption: only one profile
 	profile = rd_mouse::rd_profile::profile_1;
 
+	_i_changes.profiles[profile] = true;
 	_s_dpi_levels[rd_profile_to_m686_profile(profile)][level] = dpi;
 	return 0;
 }
 
 int mouse_m686::set_key_mapping( rd_profile profile, int key, std::array<uint8_t, 4> mapping ){
+	_i_changes.profiles[profile] = true;
 	_s_keymap_data[rd_profile_to_m686_profile(profile)][key][0] = mapping[0];
 	_s_keymap_data[rd_profile_to_m686_profile(profile)][key][1] = mapping[1];
 	_s_keymap_data[rd_profile_to_m686_profile(profile)][key][2] = mapping[2];
@@ -175,10 +186,14 @@ int mouse_m686::set_key_mapping( rd_profile profile, int key, std::string mappin
 	profile = rd_mouse::rd_profile::profile_1;
 
 	// the M686 uses different keycodes, therefore the decoding is done here
-	if( _c_keyboard_key_values.find(mapping) != _c_keyboard_key_values.end() ){ // keyboard key
+	const auto* keyboard_key = _c_keyboard_key_values.find( mapping );
+	const auto* keycode = rd_mouse_wireless::_c_keycodes.find( mapping );
+
+	if( keyboard_key != nullptr ){ // keyboard key
 
 		// the button gets mapped as "default"
-		_s_keymap_data[rd_profile_to_m686_profile(profile)][key] = rd_mouse_wireless::_c_keycodes["keyboard_key"];
+		_i_changes.profiles[profile] = true;
+		_s_keymap_data[rd_profile_to_m686_profile(profile)][key] = rd_mouse_wireless::_c_keycodes.find("keyboard_key")->value;
 		
 		// and additional packets are sent
 		_s_keyboard_key_packets.push_back(_c_data_button_as_keyboard_key);
@@ -187,15 +202,16 @@ int mouse_m686::set_key_mapping( rd_profile profile, int key, std::string mappin
 		_s_keyboard_key_packets.back()[4] = _c_keyboard_key_buttons[key][1];
 		_s_keyboard_key_packets.back()[16] = _c_keyboard_key_buttons[key][2];
 
-		_s_keyboard_key_packets.back()[8] = _c_keyboard_key_values[mapping];
-		_s_keyboard_key_packets.back()[11] = _c_keyboard_key_values[mapping];
+		_s_keyboard_key_packets.back()[8] = keyboard_key->value;
+		_s_keyboard_key_packets.back()[11] = keyboard_key->value;
 
-		_s_keyboard_key_packets.back()[13] = _i_keyboard_key_checksum(_c_keyboard_key_values[mapping]);
+		_s_keyboard_key_packets.back()[13] = _i_keyboard_key_checksum(keyboard_key->value);
 
 
-	}else if( rd_mouse_wireless::_c_keycodes.find(mapping) != rd_mouse_wireless::_c_keycodes.end() ){ // mouse buttons, special functions, ...
+	}else if( keycode != nullptr ){ // mouse buttons, special functions, ...
 
-		_s_keymap_data[rd_profile_to_m686_profile(profile)][key] = rd_mouse_wireless::_c_keycodes[mapping];
+		_i_changes.profiles[profile] = true;
+		_s_keymap_data[rd_profile_to_m686_profile(profile)][key] = keycode->value;
 
 	}
 	
@@ -203,6 +219,7 @@ int mouse_m686::set_key_mapping( rd_profile profile, int key, std::string mappin
 }
 
 int mouse_m686::set_report_rate( rd_profile profile, rd_report_rate report_rate ){
+	_i_changes.profiles[profile] = true;
 	_s_report_rates[rd_profile_to_m686_profile(profile)] = report_rate;
 	return 0;
 }
@@ -222,6 +239,7 @@ int mouse_m686::set_macro( int macro_number, std::string file ){
 	
 	std::array< uint8_t, 256 > macro_bytes;
 	_i_encode_macro( macro_bytes, config_in, 8 );
+	_i_changes.macros[macro_number-1] = true;
 	std::copy( macro_bytes.begin()+8, macro_bytes.end(), _s_macro_data[macro_number-1].begin()+8 );
 	
 	config_in.close();
@@ -263,6 +281,8 @@ int mouse_m686::set_all_macros( std::string file ){
 		
 	}
 	
+	_i_changes.macros.fill( true );
+	
 	// encode and store all macros
 	for( int i = 0; i < 15; i++ ){
 		
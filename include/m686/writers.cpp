@@ -33,8 +33,10 @@ int mouse_m686::write_data(uint8_t data[][17], size_t rows){
 	uint8_t buffer_in[17];
 
 	for( size_t i = 0; i < rows; i++ ){
-		ret += libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0308, 0x0001, data[i], 17, 1000 );
-		ret += libusb_interrupt_transfer( _i_handle, 0x82, buffer_in, 17, NULL, 1000 );
+		if( _i_control_transfer( 0x21, 0x09, 0x0308, 0x0001, data[i], 17 ) < 0 )
+			ret++;
+		if( _i_interrupt_transfer( 0x82, buffer_in, 17, NULL ) < 0 )
+			ret++;
 	}
 
 	return ret;
@@ -229,3 +231,18 @@ int mouse_m686::write_macro( int macro_number ){
 	throw std::string( "Macros are not supported for the M686." );
 	return 0;
 }
+
+int mouse_m686::write_changes(){
+	return _i_write_changes(
+		[this](){ return write_settings(); },
+		[this]( int macro_number ){ return write_macro( macro_number ); },
+		[this](){ return write_profile(); }, false );
+}
+
+int mouse_m686::write_dpi( rd_profile profile ){
+	return write_dpi_settings( rd_profile_to_m686_profile( profile ) );
+}
+
+int mouse_m686::write_led( rd_profile profile ){
+	return write_led_settings( rd_profile_to_m686_profile( profile ) );
+}
@@ -24,10 +24,6 @@
 
 const std::string mouse_m711::_c_name = "711";
 
-// usb device vars
-const uint16_t mouse_m711::_c_mouse_vid = 0x04d9;
-const uint16_t mouse_m711::_c_mouse_pid = 0xfc30;
-
 // Names of the physical buttons, TODO!
 std::map< int, std::string > mouse_m711::_c_button_names = {
 	{ 0, "button_left" },
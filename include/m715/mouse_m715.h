@@ -186,6 +186,11 @@ class mouse_m715 : public rd_mouse{
 			return vid == _c_mouse_vid && pid == _c_mouse_pid;
 		}
 		
+		/// USB vendor and product ids of the mouse, see rd_mouse::model_registry
+		static constexpr std::array< rd_usb_id, 1 > usb_ids(){
+			return {{ { _c_mouse_vid, _c_mouse_pid } }};
+		}
+		
 		/// Get mouse name
 		static std::string get_name(){
 			return _c_name;
@@ -198,15 +203,34 @@ class mouse_m715 : public rd_mouse{
 		int write_profile();
 		
 		/** \brief Write the settings (leds, button mapping, dpi, etc.) to the mouse
+		 * Supports verification, see rd_mouse::set_verify().
 		 * \return 0 if successful
 		 */
 		int write_settings();
 		
 		/** \brief Write a macro to the mouse
+		 * Supports verification, see rd_mouse::set_verify().
 		 * \return 0 if successful
 		 */
 		int write_macro( int macro_number );
 		
+		/** \brief Write the settings, macros and active profile changed by the setters since the last call
+		 * Only the changed rows of the settings and macros are sent, see rd_mouse::_i_write_changes().
+		 * \return 0 if successful
+		 */
+		int write_changes();
+		
+		/** \brief Write the dpi levels of a profile to the mouse
+		 * Not supported yet, throws std::string.
+		 */
+		int write_dpi( rd_profile profile );
+		
+		/** \brief Write the lightmode, color and speed of a profile to the mouse, only the led row of the settings is sent
+		 * Used by rd_led_stream, supports verification, see rd_mouse::set_verify().
+		 * \return 0 if successful
+		 */
+		int write_led( rd_profile profile );
+		
 		/** \brief Write the number of repeats for a macro to the mouse
 		 * \return 0 if successful
 		 */
@@ -236,18 +260,31 @@ class mouse_m715 : public rd_mouse{
 		
 		
 		//reader functions (get settings from the mouse)
+		/**
+		 * \brief Read the settings from the mouse once, without decoding them.
+		 * The snapshot can be passed to several of the functions below, the mouse is only read once.
+		 * \arg selection the sections to read, only the responses needed for them are requested
+		 * \return 0 if successful
+		 */
+		int read_snapshot( rd_device_snapshot& snapshot, const rd_read_selection& selection = rd_read_selection() );
 		/// Read the settings and print the raw data to output
 		int dump_settings( std::ostream& output );
+		/// Print the raw data of a snapshot to output
+		int dump_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This does not alter the internal settings of the mouse_m715 class.
 		 */
 		int read_and_print_settings( std::ostream& output );
+		/// Print the configuration of a snapshot in .ini format to output, see read_and_print_settings( std::ostream& )
+		int read_and_print_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This updates the internal settings of the mouse_m715 class.
 		 */
 		int read_settings();
+		/// Update the internal settings from a snapshot, see read_settings()
+		int read_settings( const rd_device_snapshot& snapshot );
 		
 		
 		
@@ -264,9 +301,9 @@ class mouse_m715 : public rd_mouse{
 
 		//usb device vars
 		/// USB vendor id
-		static const uint16_t _c_mouse_vid;
+		static constexpr uint16_t _c_mouse_vid = 0x04d9;
 		/// USB product id
-		static const uint16_t _c_mouse_pid;
+		static constexpr uint16_t _c_mouse_pid = 0xfc39;
 		
 		//setting vars
 		rd_profile _s_profile;
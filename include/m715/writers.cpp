@@ -22,21 +22,27 @@
 
 int mouse_m715::write_profile(){
 	
-	//prepare data
-	uint8_t buffer[6][16];
-	for( int i = 0; i < 6; i++ ){
-		std::copy(std::begin(_c_data_s_profile[i]), std::end(_c_data_s_profile[i]), std::begin(buffer[i]));
+	//prepare the packets of all profiles once, they only differ in the profile number
+	if( _i_profile_packets[0].empty() ){
+		
+		uint8_t buffer[6][16];
+		for( int i = 0; i < 6; i++ ){
+			std::copy(std::begin(_c_data_s_profile[i]), std::end(_c_data_s_profile[i]), std::begin(buffer[i]));
+		}
+		
+		for( int profile = 0; profile < 5; profile++ ){
+			
+			//modify buffer from default to include the profile
+			buffer[0][8] = profile;
+			
+			for( int i = 0; i < 6; i++ ){
+				_i_profile_packets[profile].emplace_back( 0x0302, buffer[i], 16 );
+			}
+		}
 	}
 	
-	//modify buffer from default to include specified profile
-	buffer[0][8] = _s_profile;
-	
 	//send data
-	for( int i = 0; i < 6; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
-	}
-	
-	return 0;
+	return _i_write_packets( _i_profile_packets[_s_profile] );
 }
 
 int mouse_m715::write_settings(){
@@ -130,24 +136,27 @@ int mouse_m715::write_settings(){
 	*
 	*/
 	
+	std::vector< rd_packet > packets;
+	
 	//send data 1
 	for( int i = 0; i < rows1; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer1[i], 16 );
 	}
 	
 	/* Currently no data capture available
 	 * 
-	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 64, 1000 );
+	//send data 2 (the scrollspeed can not be read back)
+	packets.emplace_back( 0x0302, buffer2, 64 );
+	packets.back().verify = false;
 	
 	//send data 3
 	for( int i = 0; i < rows3; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer3[i], 16 );
 	}
 	* 
 	*/
 	
-	return 0;
+	return _i_write_verified( packets );
 }
 
 int mouse_m715::write_macro( int macro_number ){
@@ -169,14 +178,64 @@ int mouse_m715::write_macro( int macro_number ){
 	uint8_t buffer3[16];
 	std::copy(std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3));
 	
+	std::vector< rd_packet > packets;
+	
 	//send data 1
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer1, 16 );
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+	packets.emplace_back( 0x0302, buffer2, 256 );
 	
 	//send data 3
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer3, 16 );
 	
+	return _i_write_verified( packets );
+}
+
+int mouse_m715::write_changes(){
+	return _i_write_changes(
+		[this](){ return write_settings(); },
+		[this]( int macro_number ){ return write_macro( macro_number ); },
+		[this](){ return write_profile(); }, true );
+}
+
+int mouse_m715::write_dpi( rd_profile profile ){
+	// missing data, the dpi levels are not written by write_settings() either
+	(void)profile;
+	throw std::string( "Writing the DPI levels is not supported for the M715." );
 	return 0;
 }
+
+int mouse_m715::write_led( rd_profile profile ){
+	
+	//prepare data 1
+	int rows1 = sizeof(_c_data_settings_1) / sizeof(_c_data_settings_1[0]);
+	uint8_t buffer1[rows1][16];
+	for( int i = 0; i < rows1; i++ ){
+		std::copy(std::begin(_c_data_settings_1[i]), std::end(_c_data_settings_1[i]), std::begin(buffer1[i]));
+	}
+	
+	//modify buffer to include the led settings, the same rows as in write_settings()
+	for( int i = 0; i < 5; i++ ){
+		std::array<uint8_t, 2> lightmode_bytes = {0x01, 0x02}; // default value is lightmode_static, only relevent in case of an error
+		_i_encode_lightmode( _s_lightmodes[i], lightmode_bytes );
+		buffer1[3+(2*i)][11] = lightmode_bytes.at(0);
+		buffer1[3+(2*i)][13] = lightmode_bytes.at(1);
+	}
+	for( int i = 0; i < 5; i++ ){
+		buffer1[1+(2*i)][8] = _s_colors[i].at(0);
+		buffer1[1+(2*i)][9] = _s_colors[i].at(1);
+		buffer1[1+(2*i)][10] = _s_colors[i].at(2);
+		buffer1[1+(2*i)][12] = _s_speed_levels[i];
+	}
+	
+	std::vector< rd_packet > packets;
+	
+	//send the color row and the lightmode row of the profile, then the last row of data 1
+	packets.emplace_back( 0x0302, buffer1[1+(2*profile)], 16 );
+	packets.emplace_back( 0x0302, buffer1[3+(2*profile)], 16 );
+	if( 3+(2*profile) != rows1-1 )
+		packets.emplace_back( 0x0302, buffer1[rows1-1], 16 );
+	
+	return _i_write_settings_rows( packets );
+}
@@ -24,10 +24,6 @@
 
 const std::string mouse_m908::_c_name = "908";
 
-// usb device vars
-const uint16_t mouse_m908::_c_mouse_vid = 0x04d9;
-const uint16_t mouse_m908::_c_mouse_pid = 0xfc4d;
-
 // Names of the physical buttons
 std::map< int, std::string > mouse_m908::_c_button_names = {
 	{ 0, "button_left" },
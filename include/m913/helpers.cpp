@@ -28,6 +28,10 @@ mouse_m913::m913_profile mouse_m913::rd_profile_to_m913_profile( rd_profile prof
 //init libusb and open mouse
 int mouse_m913::open_mouse(){
 	
+	// nothing to open, the transfers are simulated
+	if( _i_simulated() )
+		return 0;
+	
 	//vars
 	int res = 0;
 	
@@ -77,12 +81,18 @@ int mouse_m913::open_mouse(){
 		return res;
 	}
 	
+	_i_attach_transport();
+	
 	return res;
 }
 
 // init libusb and open mouse by bus and device
 int mouse_m913::open_mouse_bus_device( uint8_t bus, uint8_t device ){
 
+	// nothing to open, the transfers are simulated
+	if( _i_simulated() )
+		return 0;
+	
 	//vars
 	int res = 0;
 	
@@ -155,12 +165,19 @@ int mouse_m913::open_mouse_bus_device( uint8_t bus, uint8_t device ){
 		return res;
 	}
 	
+	_i_attach_transport();
+	
 	return res;
 }
 
 // close mouse
 int mouse_m913::close_mouse(){
 
+	if( _i_simulated() )
+		return 0;
+	
+	_i_get_transport().set_handle( nullptr );
+	
 	// release interfaces 0 and 1
 	libusb_release_interface( _i_handle, 0 );
 	libusb_release_interface( _i_handle, 1 );
@@ -276,22 +293,8 @@ int mouse_m913::print_settings( std::ostream& output ){
 		
 	}
 	
-	// macros
-	output << "\n# Macros\n";
-	for( int i = 0; i < 15; i++ ){
-		
-		// is macro not defined ?
-		if( _s_macro_data[i][8] == 0 && _s_macro_data[i][9] == 0 && _s_macro_data[i][10] == 0 )
-			continue;
-		
-		// _i_decode_macros takes a vector as argument, copy array to vector
-		std::vector< uint8_t > macro_bytes( _s_macro_data[i].begin(), _s_macro_data[i].end() );
-		
-		// print macro (macro data starts at byte 8)
-		output << "\n;## macro" << i+1 << "\n";
-		_i_decode_macro( macro_bytes, output, ";# ", 8 );
-		
-	}
+	// macros (macro data starts at byte 8)
+	_i_decode_macros( _s_macro_data, output, 8 );
 	
 	return 0;
 }
@@ -302,16 +305,10 @@ int mouse_m913::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, s
 	std::stringstream mapping_stream;
 
 	// known keycode ?
-	for( auto keycode : rd_mouse_wireless::_c_keycodes ){
-		if(
-			bytes.at(0) == keycode.second.at(0) &&
-			bytes.at(1) == keycode.second.at(1) &&
-			bytes.at(2) == keycode.second.at(2) &&
-			bytes.at(3) == keycode.second.at(3)
-		){
-			ret = 0;
-			mapping_stream << keycode.first;
-		}
+	const auto* keycode = rd_mouse_wireless::_c_keycodes.find_value( bytes );
+	if( keycode != nullptr ){
+		ret = 0;
+		mapping_stream << keycode->name;
 	}
 
 	// unknown keycode
@@ -185,7 +185,15 @@ class mouse_m913 : public rd_mouse, protected rd_mouse_wireless {
 		
 		/// Checks if the mouse has the given vendor and product id
 		static bool has_vid_pid( uint16_t vid, uint16_t pid ){
-			return vid == _c_mouse_vid && _c_all_pids.find(pid) != _c_all_pids.end();
+			return vid == _c_mouse_vid && std::find( _c_all_pids.begin(), _c_all_pids.end(), pid ) != _c_all_pids.end();
+		}
+		
+		/// USB vendor and product ids of the mouse, see rd_mouse::model_registry
+		static constexpr auto usb_ids(){
+			std::array< rd_usb_id, _c_all_pids.size() > ids = {};
+			for( size_t i = 0; i < _c_all_pids.size(); i++ )
+				ids[i] = { _c_mouse_vid, _c_all_pids[i] };
+			return ids;
 		}
 		
 		/// Get mouse name
@@ -209,6 +217,23 @@ class mouse_m913 : public rd_mouse, protected rd_mouse_wireless {
 		 */
 		int write_macro( int macro_number );
 		
+		/** \brief Write the settings, macros and active profile changed by the setters since the last call
+		 * The changed sections are written completely, the packets of this protocol depend on each other.
+		 * \return 0 if successful
+		 */
+		int write_changes();
+		
+		/** \brief Write the dpi levels of a profile to the mouse, only the dpi settings are sent
+		 * \return 0 if successful
+		 */
+		int write_dpi( rd_profile profile );
+		
+		/** \brief Write the lightmode, color and speed of a profile to the mouse, only the led settings are sent
+		 * Used by rd_led_stream.
+		 * \return 0 if successful
+		 */
+		int write_led( rd_profile profile );
+		
 		
 		
 		//helper functions
@@ -233,18 +258,31 @@ class mouse_m913 : public rd_mouse, protected rd_mouse_wireless {
 				
 		
 		//reader functions (get settings from the mouse)
+		/**
+		 * \brief Read the settings from the mouse once, without decoding them.
+		 * The snapshot can be passed to several of the functions below, the mouse is only read once.
+		 * \arg selection the sections to read, only the responses needed for them are requested
+		 * \return 0 if successful
+		 */
+		int read_snapshot( rd_device_snapshot& snapshot, const rd_read_selection& selection = rd_read_selection() );
 		/// Read the settings and print the raw data to output
 		int dump_settings( std::ostream& output );
+		/// Print the raw data of a snapshot to output
+		int dump_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This does not alter the internal settings of the mouse_m913 class.
 		 */
 		int read_and_print_settings( std::ostream& output );
+		/// Print the configuration of a snapshot in .ini format to output, see read_and_print_settings( std::ostream& )
+		int read_and_print_settings( const rd_device_snapshot& snapshot, std::ostream& output );
 		/**
 		 * \brief Read the settings and print the configuration in .ini format to output.
 		 * This updates the internal settings of the mouse_m913 class.
 		 */
 		int read_settings();
+		/// Update the internal settings from a snapshot, see read_settings()
+		int read_settings( const rd_device_snapshot& snapshot );
 		
 		
 		
@@ -305,9 +343,12 @@ class mouse_m913 : public rd_mouse, protected rd_mouse_wireless {
 		static const std::string _c_name;
 
 		//usb device vars
-		static std::set< uint16_t > _c_all_pids;
+		static constexpr std::array< uint16_t, 2 > _c_all_pids = {
+			0xfa07, // wireless connection
+			0xfa08  // wired connection
+		};
 		/// USB vendor id
-		static const uint16_t _c_mouse_vid;
+		static constexpr uint16_t _c_mouse_vid = 0x25a7;
 		/// USB product id, needs to be explicitly set
 		uint16_t _c_mouse_pid = 0;
 
@@ -22,22 +22,28 @@
 
 int mouse_m990::write_profile(){
 	
-	//prepare data
-	uint8_t buffer[5][16];
-	for( int i = 0; i < 5; i++ ){
-		std::copy(std::begin(_c_data_profile[i]), std::end(_c_data_profile[i]), std::begin(buffer[i]));
+	//prepare the packets of all profiles once, they only differ in the profile number
+	if( _i_profile_packets[0].empty() ){
+		
+		uint8_t buffer[5][16];
+		for( int i = 0; i < 5; i++ ){
+			std::copy(std::begin(_c_data_profile[i]), std::end(_c_data_profile[i]), std::begin(buffer[i]));
+		}
+		
+		for( int profile = 0; profile < 5; profile++ ){
+			
+			//modify buffer from default to include the profile
+			buffer[1][8] = profile;
+			
+			for( int i = 0; i < 5; i++ ){
+				_i_profile_packets[profile].emplace_back( 0x0302, buffer[i], 16 );
+			}
+			_i_profile_packets[profile].emplace_back( 0x0303, nullptr, 0, 0xa1, 0x01 );
+		}
 	}
 	
-	//modify buffer from default to include specified profile
-	buffer[1][8] = _s_profile;
-	
 	//send data
-	for( int i = 0; i < 5; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
-	}
-	libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, NULL, 0, 1000 );
-	
-	return 0;
+	return _i_write_packets( _i_profile_packets[_s_profile] );
 }
 
 int mouse_m990::write_settings(){
@@ -111,39 +117,41 @@ int mouse_m990::write_settings(){
 		buffer1[14][2+(2*i)] = _i_encode_report_rate(_s_report_rates[i]);
 	*/
 	
+	std::vector< rd_packet > packets;
+	
 	// send data
 	int pos1 = 0, pos2 = 0, pos3 = 0;
 	
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[1], 16, 1000 );
+	packets.emplace_back( 0x0302, buffer1[0], 16 );
+	packets.emplace_back( 0x0302, buffer1[1], 16 );
 	pos1 += 2;
 	
-	libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, NULL, 0, 1000 );
+	packets.emplace_back( 0x0303, nullptr, 0, 0xa1, 0x01 );
 	
 	for( int i = 0; i < 5; i++ ){
 		
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0304, 0x0002, buffer2[pos2], 256, 1000 );
+		packets.emplace_back( 0x0304, buffer2[pos2], 256 );
 		pos2++;
 		
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[pos1], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer1[pos1], 16 );
 		pos1++;
 		
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0303, 0x0002, buffer3[pos3], 64, 1000 );
+		packets.emplace_back( 0x0303, buffer3[pos3], 64 );
 		pos3++;
 		
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[pos1], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer1[pos1], 16 );
 		pos1++;
 		
 	}
 	
 	for( ; pos1 < 20; pos1++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[pos1], 16, 1000 );
+		packets.emplace_back( 0x0302, buffer1[pos1], 16 );
 	}
 	
-	libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, NULL, 0, 1000 );
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[20], 16, 1000 );
+	packets.emplace_back( 0x0303, nullptr, 0, 0xa1, 0x01 );
+	packets.emplace_back( 0x0302, buffer1[20], 16 );
 	
-	return 0;
+	return _i_write_packets( packets );
 }
 
 // TODO! check for m990
@@ -166,14 +174,37 @@ int mouse_m990::write_macro( int macro_number ){
 	uint8_t buffer3[16];
 	std::copy(std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3));
 	
+	std::vector< rd_packet > packets;
+	
 	//send data 1
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer1, 16 );
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+	packets.emplace_back( 0x0302, buffer2, 256 );
 	
 	//send data 3
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	packets.emplace_back( 0x0302, buffer3, 16 );
 	
+	return _i_write_packets( packets );
+}
+
+int mouse_m990::write_changes(){
+	return _i_write_changes(
+		[this](){ return write_settings(); },
+		[this]( int macro_number ){ return write_macro( macro_number ); },
+		[this](){ return write_profile(); }, false );
+}
+
+int mouse_m990::write_dpi( rd_profile profile ){
+	// missing data, the dpi levels are not written by write_settings() either
+	(void)profile;
+	throw std::string( "Writing the DPI levels is not supported for the M990." );
+	return 0;
+}
+
+int mouse_m990::write_led( rd_profile profile ){
+	// the settings are only written completely
+	(void)profile;
+	throw std::string( "LED streaming is not supported for the M990." );
 	return 0;
 }
@@ -24,10 +24,6 @@
 
 const std::string mouse_m990chroma::_c_name = "990chroma";
 
-// usb device vars
-const uint16_t mouse_m990chroma::_c_mouse_vid = 0x04d9;
-const uint16_t mouse_m990chroma::_c_mouse_pid = 0xfc41;
-
 // Names of the physical buttons
 std::map< int, std::string > mouse_m990chroma::_c_button_names = {
 	{ 0, "button_left" },
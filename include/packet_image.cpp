@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "packet_image.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void rd_packet_image::_i_append( std::string& data, uint64_t value, size_t bytes ){
+	for( size_t i = 0; i < bytes; i++ )
+		data.push_back( (char)((value >> (8*i)) & 0xff) );
+}
+
+uint64_t rd_packet_image::hash( const std::string& data, uint64_t seed ){
+
+	uint64_t result = seed;
+	for( unsigned char c : data ){
+		result ^= c;
+		result *= 0x100000001b3;
+	}
+
+	return result;
+}
+
+int rd_packet_image::write( const std::string& path, const std::string& model, uint64_t config_hash,
+	const std::vector< rd_mouse::rd_packet >& packets ){
+
+	if( model.size() >= _c_model_length )
+		return 1;
+
+	// header
+	std::string image( "RDPKTIMG" );
+	_i_append( image, version, 4 );
+	_i_append( image, packets.size(), 4 );
+	_i_append( image, config_hash, 8 );
+	image += model;
+	image.append( _c_model_length - model.size(), '\0' );
+
+	// packets
+	for( auto& packet : packets ){
+
+		if( packet.data.size() > 0xffff )
+			return 1;
+
+		_i_append( image, packet.request_type, 1 );
+		_i_append( image, packet.request, 1 );
+		_i_append( image, packet.value, 2 );
+		_i_append( image, packet.index, 2 );
+		_i_append( image, packet.data.size(), 2 );
+		image.append( packet.data.begin(), packet.data.end() );
+	}
+
+	std::ofstream out( path, std::ios::binary | std::ios::trunc );
+	if( !out.is_open() )
+		return 1;
+
+	out.write( image.data(), image.size() );
+	out.close();
+
+	return out.fail() ? 1 : 0;
+}
+
+int rd_packet_image::open( const std::string& path ){
+
+	close();
+
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return 1;
+
+	struct stat file_stat;
+	if( fstat( fd, &file_stat ) != 0 ){
+		::close( fd );
+		return 1;
+	}
+	if( file_stat.st_size < (off_t)_c_header_size ){
+		::close( fd );
+		return 2;
+	}
+
+	// the mapping stays valid after closing the file descriptor
+	void* data = mmap( nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+
+	if( data == MAP_FAILED )
+		return 1;
+
+	_i_data = (const uint8_t*)data;
+	_i_size = file_stat.st_size;
+
+	// check header
+	if( std::memcmp( _i_data, "RDPKTIMG", 8 ) != 0 || _i_read_32( _i_data+8 ) != version ||
+		_i_data[_c_header_size-1] != 0 ){
+		close();
+		return 2;
+	}
+
+	_i_packet_count = _i_read_32( _i_data+12 );
+	_i_config_hash = _i_read_64( _i_data+16 );
+	_i_model = std::string( (const char*)_i_data+24 );
+
+	// check that all packets are complete and nothing follows them
+	size_t position = _c_header_size;
+	for( uint32_t i = 0; i < _i_packet_count; i++ ){
+
+		if( _i_size - position < _c_packet_header_size ){
+			close();
+			return 2;
+		}
+
+		size_t length = _i_read_16( _i_data+position+6 );
+		position += _c_packet_header_size;
+
+		if( _i_size - position < length ){
+			close();
+			return 2;
+		}
+
+		position += length;
+	}
+
+	if( position != _i_size ){
+		close();
+		return 2;
+	}
+
+	return 0;
+}
+
+void rd_packet_image::close(){
+
+	if( _i_data != nullptr )
+		munmap( (void*)_i_data, _i_size );
+
+	_i_data = nullptr;
+	_i_size = 0;
+	_i_packet_count = 0;
+	_i_config_hash = 0;
+	_i_model.clear();
+}
+
+void rd_packet_image::get_packets( std::vector< rd_mouse::rd_packet >& packets ){
+
+	packets.reserve( packets.size() + _i_packet_count );
+
+	// the packets have been checked by open()
+	size_t position = _c_header_size;
+	for( uint32_t i = 0; i < _i_packet_count; i++ ){
+
+		const uint8_t* packet = _i_data+position;
+		size_t length = _i_read_16( packet+6 );
+
+		packets.emplace_back( _i_read_16( packet+2 ), packet+_c_packet_header_size, length, packet[0], packet[1] );
+		packets.back().index = _i_read_16( packet+4 );
+
+		position += _c_packet_header_size + length;
+	}
+}
@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_PACKET_IMAGE
+#define RD_PACKET_IMAGE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rd_mouse.h"
+
+/**
+ * This class reads and writes packet images, files holding the encoded
+ * packets of the writer functions for one model (see mouse_m908 --compile
+ * and --apply).
+ *
+ * Applying an image does not parse the configuration again, the packets
+ * are read from the mapped file and sent as they are.
+ *
+ * File format, all numbers little endian:
+ * - header (48 bytes): magic "RDPKTIMG", version (uint32), packet count (uint32),
+ *   config hash (uint64), model name (24 bytes, zero padded)
+ * - for each packet: request type (uint8), request (uint8), value (uint16),
+ *   index (uint16), data length (uint16), data
+ */
+class rd_packet_image{
+
+	public:
+
+		/// Version of the file format, images with a different version are rejected
+		static const uint32_t version = 1;
+
+		rd_packet_image(){}
+		~rd_packet_image(){ close(); }
+		rd_packet_image( const rd_packet_image& ) = delete;
+		rd_packet_image& operator=( const rd_packet_image& ) = delete;
+
+		/** \brief Write an image
+		 * \arg model name of the model the packets were encoded for
+		 * \arg config_hash identifies the configuration, see hash()
+		 * \return 0 if successful
+		 */
+		static int write( const std::string& path, const std::string& model, uint64_t config_hash,
+			const std::vector< rd_mouse::rd_packet >& packets );
+
+		/** \brief Map an image and check the header and all packets
+		 * \return 0 if successful, 1 if the file could not be read, 2 if it is not a valid image
+		 */
+		int open( const std::string& path );
+
+		/// Unmap the image
+		void close();
+
+		/// Name of the model stored in the header
+		const std::string& get_model(){ return _i_model; }
+
+		/// Config hash stored in the header
+		uint64_t get_config_hash(){ return _i_config_hash; }
+
+		/// Copy the packets from the mapped image
+		void get_packets( std::vector< rd_mouse::rd_packet >& packets );
+
+		/// 64-bit FNV-1a hash, used to identify the configuration of an image
+		static uint64_t hash( const std::string& data, uint64_t seed = 0xcbf29ce484222325 );
+
+	private:
+
+		/// Size of the header in bytes
+		static const size_t _c_header_size = 48;
+		/// Size of the fixed part of a packet in bytes
+		static const size_t _c_packet_header_size = 8;
+		/// Length of the model name field
+		static const size_t _c_model_length = 24;
+
+		/// The mapped file, nullptr if not open
+		const uint8_t* _i_data = nullptr;
+		/// Size of the mapped file
+		size_t _i_size = 0;
+		/// Number of packets
+		uint32_t _i_packet_count = 0;
+		/// Config hash from the header
+		uint64_t _i_config_hash = 0;
+		/// Model name from the header
+		std::string _i_model;
+
+		/// Read little endian numbers
+		static uint16_t _i_read_16( const uint8_t* data ){ return data[0] | (data[1] << 8); }
+		static uint32_t _i_read_32( const uint8_t* data ){ return _i_read_16( data ) | ((uint32_t)_i_read_16( data+2 ) << 16); }
+		static uint64_t _i_read_64( const uint8_t* data ){ return _i_read_32( data ) | ((uint64_t)_i_read_32( data+4 ) << 32); }
+
+		/// Append little endian numbers
+		static void _i_append( std::string& data, uint64_t value, size_t bytes );
+};
+
+#endif
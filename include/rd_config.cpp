@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "rd_config.h"
+
+int rd_config::_i_parse_byte( const std::string& text, uint8_t& value ){
+
+	size_t start = ( text.compare( 0, 2, "0x" ) == 0 || text.compare( 0, 2, "0X" ) == 0 ) ? 2 : 0;
+
+	if( text.length() <= start || text.length() > start + 2 )
+		return 1;
+
+	unsigned int result = 0;
+	for( size_t i = start; i < text.length(); i++ ){
+
+		char c = text[i];
+		if( c >= '0' && c <= '9' )
+			result = result*16 + (c - '0');
+		else if( c >= 'a' && c <= 'f' )
+			result = result*16 + (c - 'a' + 10);
+		else if( c >= 'A' && c <= 'F' )
+			result = result*16 + (c - 'A' + 10);
+		else
+			return 1;
+	}
+
+	value = (uint8_t)result;
+	return 0;
+}
+
+int rd_config::load( const std::string& path,
+	const std::map< rd_mouse::rd_lightmode, std::string >& lightmodes,
+	const std::map< rd_mouse::rd_report_rate, std::string >& report_rates,
+	const std::map< int, std::string >& buttons,
+	std::vector< std::string >& errors ){
+
+	simple_ini_parser pt;
+	if( pt.read_ini( path ) != 0 )
+		return 1;
+
+	for( int i = 0; i < profile_count; i++ ){
+
+		rd_profile_config& profile = profiles[i];
+		profile = rd_profile_config();
+
+		// every key is looked up once, prefix is "profileN."
+		const std::string prefix = "profile" + std::to_string(i+1) + ".";
+		std::string value;
+
+		// lightmode
+		value = pt.get( prefix+"lightmode", "" );
+		if( !value.empty() ){
+			for( auto& lightmode : lightmodes ){
+				if( value == lightmode.second )
+					profile.lightmode = lightmode.first;
+			}
+			if( !profile.lightmode )
+				errors.push_back( prefix+"lightmode: unknown lightmode "+value );
+		}
+
+		// color, rrggbb
+		value = pt.get( prefix+"color", "" );
+		if( !value.empty() ){
+			std::array< uint8_t, 3 > color;
+			if( value.length() == 6 && _i_parse_byte( value.substr(0,2), color[0] ) == 0 &&
+				_i_parse_byte( value.substr(2,2), color[1] ) == 0 && _i_parse_byte( value.substr(4,2), color[2] ) == 0 )
+				profile.color = color;
+			else
+				errors.push_back( prefix+"color: expected rrggbb, not "+value );
+		}
+
+		// brightness, speed and scrollspeed
+		for( auto& [ key, setting ] : { std::make_pair( "brightness", &profile.brightness ),
+			std::make_pair( "speed", &profile.speed ), std::make_pair( "scrollspeed", &profile.scrollspeed ) } ){
+
+			value = pt.get( prefix+key, "" );
+			if( !value.empty() ){
+				uint8_t byte;
+				if( _i_parse_byte( value, byte ) == 0 )
+					*setting = byte;
+				else
+					errors.push_back( prefix+key+": expected a hexadecimal number, not "+value );
+			}
+		}
+
+		// DPI
+		for( int j = 0; j < dpi_level_count; j++ ){
+
+			const std::string dpi_key = prefix + "dpi" + std::to_string(j+1);
+
+			profile.dpi_disabled[j] = ( pt.get( dpi_key+"_enable", "" ) == "0" );
+			profile.dpi[j] = pt.get( dpi_key, "" );
+		}
+
+		// report rate
+		value = pt.get( prefix+"report_rate", "" );
+		if( !value.empty() ){
+			for( auto& report_rate : report_rates ){
+				if( value == report_rate.second )
+					profile.report_rate = report_rate.first;
+			}
+			if( !profile.report_rate )
+				errors.push_back( prefix+"report_rate: unknown report rate "+value );
+		}
+
+		// button mapping
+		for( auto& button : buttons ){
+			value = pt.get( prefix+button.second, "" );
+			if( !value.empty() )
+				profile.buttons.emplace_back( button.first, value );
+		}
+	}
+
+	return 0;
+}
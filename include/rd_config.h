@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_CONFIG
+#define RD_CONFIG
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rd_mouse.h"
+#include "load_config.h"
+
+/**
+ * This class holds the settings of a configuration file (-c), resolved
+ * once into typed values for all profiles.
+ *
+ * The names of lightmodes, report rates and buttons depend on the model,
+ * load() receives them from the mouse object. Values that depend on the
+ * model in other ways (DPI values, button mappings, value ranges) are
+ * checked when they are passed to the setter functions of the mouse.
+ */
+class rd_config{
+
+	public:
+
+		/// Number of profiles in a configuration file
+		static const int profile_count = 5;
+		/// Number of DPI levels per profile in a configuration file
+		static const int dpi_level_count = 5;
+
+		/// The settings of one profile, unset values are not changed on the mouse
+		struct rd_profile_config{
+			std::optional< rd_mouse::rd_lightmode > lightmode;
+			std::optional< std::array< uint8_t, 3 > > color;
+			std::optional< uint8_t > brightness;
+			std::optional< uint8_t > speed;
+			std::optional< uint8_t > scrollspeed;
+			/// dpiN_enable=0
+			std::array< bool, dpi_level_count > dpi_disabled = {};
+			/// dpiN, empty if not set (the format depends on the model)
+			std::array< std::string, dpi_level_count > dpi;
+			std::optional< rd_mouse::rd_report_rate > report_rate;
+			/// button number → mapping
+			std::vector< std::pair< int, std::string > > buttons;
+		};
+
+		/// The settings of all profiles, profiles[0] is profile1
+		std::array< rd_profile_config, profile_count > profiles;
+
+		/** \brief Read the configuration file and resolve all settings
+		 * All invalid values are reported in errors, as "key: message".
+		 * \arg lightmodes, report_rates, buttons the names used by the model
+		 * \return 0 if the file could be read, the settings are only complete if errors is empty
+		 */
+		int load( const std::string& path,
+			const std::map< rd_mouse::rd_lightmode, std::string >& lightmodes,
+			const std::map< rd_mouse::rd_report_rate, std::string >& report_rates,
+			const std::map< int, std::string >& buttons,
+			std::vector< std::string >& errors );
+
+		/** \brief Apply the settings to a mouse with its setters, as done for mouse_m908 -c
+		 * Values the mouse does not accept are added to errors, as "profileN.key: message".
+		 * \arg mouse an object of any model class
+		 */
+		template< typename T > void apply( T& mouse, std::vector< std::string >& errors ) const;
+
+	private:
+
+		/** \brief Parse a hexadecimal byte, with or without 0x prefix
+		 * \return 0 if valid
+		 */
+		static int _i_parse_byte( const std::string& text, uint8_t& value );
+};
+
+template< typename T > void rd_config::apply( T& mouse, std::vector< std::string >& errors ) const{
+
+	for( int i = 0; i < profile_count; i++ ){
+
+		rd_mouse::rd_profile profile = (rd_mouse::rd_profile)i;
+		const rd_profile_config& settings = profiles[i];
+		const std::string prefix = "profile" + std::to_string(i+1) + ".";
+
+		if( settings.lightmode )
+			mouse.set_lightmode( profile, *settings.lightmode );
+
+		if( settings.color )
+			mouse.set_color( profile, *settings.color );
+
+		if( settings.brightness && mouse.set_brightness( profile, *settings.brightness ) != 0 )
+			errors.push_back( prefix+"brightness: value out of range" );
+
+		if( settings.speed && mouse.set_speed( profile, *settings.speed ) != 0 )
+			errors.push_back( prefix+"speed: value out of range" );
+
+		if( settings.scrollspeed && mouse.set_scrollspeed( profile, *settings.scrollspeed ) != 0 )
+			errors.push_back( prefix+"scrollspeed: value out of range" );
+
+		// DPI
+		for( int j = 0; j < dpi_level_count; j++ ){
+
+			// DPI level disabled
+			if( settings.dpi_disabled[j] )
+				mouse.set_dpi_enable( profile, j, false );
+
+			// DPI value
+			if( !settings.dpi[j].empty() && mouse.set_dpi( profile, j, settings.dpi[j] ) != 0 )
+				errors.push_back( prefix+"dpi"+std::to_string(j+1)+": unknown DPI value "+settings.dpi[j] );
+		}
+
+		if( settings.report_rate )
+			mouse.set_report_rate( profile, *settings.report_rate );
+
+		// button mapping
+		for( auto& button : settings.buttons ){
+			if( mouse.set_key_mapping( profile, button.first, button.second ) != 0 )
+				errors.push_back( prefix+mouse.button_names()[button.first]+": invalid button mapping "+button.second );
+		}
+	}
+}
+
+#endif
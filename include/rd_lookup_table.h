@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_LOOKUP_TABLE
+#define RD_LOOKUP_TABLE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/// A name and its value, an entry of rd_lookup_table
+template< typename T > struct rd_named_value{
+	std::string_view name;
+	T value;
+};
+
+/**
+ * This class is a read-only name ↔ value table that is built at compile
+ * time (see rd_lookup_table_data), it replaces the std::map lookup tables.
+ *
+ * The entries are sorted by name, iterating over the table visits the
+ * names in the same order as a std::map. A lookup by name is a binary
+ * search. A lookup by value uses a dense index for uint8_t values and a
+ * binary search over the entries sorted by value for other values, it
+ * returns the first name (sorted by name) if several names have the same value.
+ */
+template< typename T > class rd_lookup_table{
+
+	public:
+
+		constexpr rd_lookup_table( const rd_named_value<T>* entries, size_t size,
+			const uint16_t* value_order, const int16_t* byte_index ) :
+			_i_entries(entries), _i_size(size), _i_value_order(value_order), _i_byte_index(byte_index) {}
+
+		/// Find an entry by name, nullptr if the name is unknown
+		constexpr const rd_named_value<T>* find( std::string_view name ) const{
+
+			size_t low = 0, high = _i_size;
+			while( low < high ){
+				size_t middle = (low + high) / 2;
+				if( _i_entries[middle].name < name )
+					low = middle + 1;
+				else
+					high = middle;
+			}
+
+			return ( low < _i_size && _i_entries[low].name == name ) ? &_i_entries[low] : nullptr;
+		}
+
+		/// Find an entry by value, nullptr if the value is unknown
+		constexpr const rd_named_value<T>* find_value( const T& value ) const{
+
+			if constexpr( std::is_same_v< T, uint8_t > ){
+				return ( _i_byte_index[value] < 0 ) ? nullptr : &_i_entries[_i_byte_index[value]];
+			} else{
+
+				size_t low = 0, high = _i_size;
+				while( low < high ){
+					size_t middle = (low + high) / 2;
+					if( rd_value_less( _i_entries[_i_value_order[middle]].value, value ) )
+						low = middle + 1;
+					else
+						high = middle;
+				}
+
+				return ( low < _i_size && !rd_value_less( value, _i_entries[_i_value_order[low]].value ) ) ?
+					&_i_entries[_i_value_order[low]] : nullptr;
+			}
+		}
+
+		/// Whether the name is in the table
+		constexpr bool contains( std::string_view name ) const{ return find( name ) != nullptr; }
+
+		/// Number of entries
+		constexpr size_t size() const{ return _i_size; }
+
+		/// Iterate over the entries sorted by name
+		constexpr const rd_named_value<T>* begin() const{ return _i_entries; }
+		constexpr const rd_named_value<T>* end() const{ return _i_entries + _i_size; }
+
+		/// Compares values, lexicographically for arrays
+		template< typename V > static constexpr bool rd_value_less( const V& a, const V& b ){ return a < b; }
+		template< typename V, size_t N > static constexpr bool rd_value_less( const std::array<V, N>& a, const std::array<V, N>& b ){
+			for( size_t i = 0; i < N; i++ ){
+				if( a[i] != b[i] )
+					return a[i] < b[i];
+			}
+			return false;
+		}
+
+	private:
+
+		const rd_named_value<T>* _i_entries;
+		size_t _i_size;
+		const uint16_t* _i_value_order;
+		const int16_t* _i_byte_index;
+};
+
+/**
+ * The sorted entries and indexes of a rd_lookup_table, created at compile time
+ * from an unsorted list. Objects of this type must have static storage duration,
+ * table() refers to them.
+ */
+template< typename T, size_t N > struct rd_lookup_table_data{
+
+	std::array< rd_named_value<T>, N > entries = {};
+	/// entry indexes sorted by value, stable (for equal values sorted by name)
+	std::array< uint16_t, N > value_order = {};
+	/// for uint8_t values: value → first entry index, -1 if unknown
+	std::array< int16_t, 256 > byte_index = {};
+
+	constexpr rd_lookup_table_data( const rd_named_value<T> (&list)[N] ){
+
+		// sort by name (insertion sort, std::sort is not constexpr in C++17)
+		for( size_t i = 0; i < N; i++ ){
+			size_t j = i;
+			while( j > 0 && list[i].name < entries[j-1].name ){
+				entries[j] = entries[j-1];
+				j--;
+			}
+			entries[j] = list[i];
+		}
+
+		// sort by value, stable
+		for( size_t i = 0; i < N; i++ ){
+			size_t j = i;
+			while( j > 0 && rd_lookup_table<T>::rd_value_less( entries[i].value, entries[value_order[j-1]].value ) ){
+				value_order[j] = value_order[j-1];
+				j--;
+			}
+			value_order[j] = (uint16_t)i;
+		}
+
+		// dense index for byte values
+		for( auto& index : byte_index )
+			index = -1;
+
+		if constexpr( std::is_same_v< T, uint8_t > ){
+			for( size_t i = N; i > 0; i-- )
+				byte_index[entries[i-1].value] = (int16_t)(i-1);
+		}
+	}
+
+	/// Whether all names are different, for static_assert
+	constexpr bool unique_names() const{
+		for( size_t i = 1; i < N; i++ ){
+			if( entries[i-1].name == entries[i].name )
+				return false;
+		}
+		return true;
+	}
+
+	/// The table for these entries
+	constexpr rd_lookup_table<T> table() const{
+		return rd_lookup_table<T>( entries.data(), N, value_order.data(), byte_index.data() );
+	}
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_MODEL_REGISTRY
+#define RD_MODEL_REGISTRY
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+
+/// A USB vendor and product id, see the usb_ids() functions of the models
+struct rd_usb_id{
+	uint16_t vid;
+	uint16_t pid;
+
+	constexpr bool operator<( const rd_usb_id& other ) const{
+		return vid < other.vid || (vid == other.vid && pid < other.pid);
+	}
+	constexpr bool operator==( const rd_usb_id& other ) const{
+		return vid == other.vid && pid == other.pid;
+	}
+};
+
+/// Total number of USB ids of the models in the variant V
+template< typename V, size_t I = 0 > constexpr size_t rd_usb_id_count(){
+	if constexpr( I == std::variant_size_v<V> )
+		return 0;
+	else
+		return std::variant_alternative_t< I, V >::usb_ids().size() + rd_usb_id_count< V, I+1 >();
+}
+
+/**
+ * This class finds the model of a USB device by its vendor and product id.
+ * It is built at compile time from the usb_ids() of the models in the variant V,
+ * so detection does not create an object of every model for every USB device.
+ *
+ * The entries are sorted by id and, for the same id, by the index of the model
+ * in V, which is its priority: models earlier in V take priority over later ones
+ * (mouse_generic is last). A lookup is a binary search, the object is only
+ * created for the model that has been found (see create()).
+ */
+template< typename V > class rd_model_registry{
+
+	public:
+
+		/// An id of a model, index is the index of the model in V
+		struct rd_model_entry{
+			rd_usb_id id;
+			size_t index;
+		};
+
+		constexpr rd_model_registry(){ _i_add< 0 >( 0 ); }
+
+		/** \brief Find the model with the highest priority that has an id
+		 * \arg name only match the model with this name, all models if empty
+		 * \return the entry of the model, nullptr if no model matches
+		 */
+		const rd_model_entry* find( uint16_t vid, uint16_t pid, const std::string& name = "" ) const{
+
+			rd_usb_id id = { vid, pid };
+
+			size_t low = 0, high = _i_entries.size();
+			while( low < high ){
+				size_t middle = (low + high) / 2;
+				if( _i_entries[middle].id < id )
+					low = middle + 1;
+				else
+					high = middle;
+			}
+
+			for( size_t i = low; i < _i_entries.size() && _i_entries[i].id == id; i++ ){
+				if( name == "" || name == model_name( _i_entries[i].index ) )
+					return &_i_entries[i];
+			}
+
+			return nullptr;
+		}
+
+		/// Create the object for an entry, with the id of the entry set (see set_vid() and set_pid() of the models)
+		V create( const rd_model_entry& entry ) const{
+
+			V mouse = create( entry.index );
+			std::visit( [&]( auto& m ){
+				m.set_vid( entry.id.vid );
+				m.set_pid( entry.id.pid );
+			}, mouse );
+
+			return mouse;
+		}
+
+		/// Create the object for the model with the index in V, without creating the other models
+		static V create( size_t index ){
+			static constexpr auto factories = _i_factories( std::make_index_sequence< std::variant_size_v<V> >() );
+			return factories[index]();
+		}
+
+		/// Name of the model with the index in V
+		static std::string model_name( size_t index ){
+			static constexpr auto names = _i_names( std::make_index_sequence< std::variant_size_v<V> >() );
+			return names[index]();
+		}
+
+		/// Number of models in V
+		static constexpr size_t model_count(){ return std::variant_size_v<V>; }
+
+		/// Number of ids
+		constexpr size_t size() const{ return _i_entries.size(); }
+
+	private:
+
+		std::array< rd_model_entry, rd_usb_id_count<V>() > _i_entries = {};
+
+		/// Add the ids of the models from index I, sorted by id, then by index
+		template< size_t I > constexpr void _i_add( size_t size ){
+
+			if constexpr( I < std::variant_size_v<V> ){
+
+				// insertion sort, std::sort is not constexpr in C++17
+				for( const rd_usb_id& id : std::variant_alternative_t< I, V >::usb_ids() ){
+					size_t j = size;
+					while( j > 0 && id < _i_entries[j-1].id ){
+						_i_entries[j] = _i_entries[j-1];
+						j--;
+					}
+					_i_entries[j] = rd_model_entry{ id, I };
+					size++;
+				}
+
+				_i_add< I+1 >( size );
+			}
+		}
+
+		/// A function for each model that default constructs it
+		template< size_t... I > static constexpr std::array< V(*)(), sizeof...(I) > _i_factories( std::index_sequence< I... > ){
+			return {{ []() -> V { return V( std::in_place_index< I > ); }... }};
+		}
+		/// The get_name() function of each model
+		template< size_t... I > static constexpr std::array< std::string(*)(), sizeof...(I) > _i_names( std::index_sequence< I... > ){
+			return {{ &std::variant_alternative_t< I, V >::get_name... }};
+		}
+};
+
+#endif
@@ -18,9 +18,19 @@
 
 #include "rd_mouse.h"
 
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// the USB ids of all models, built at compile time
+static constexpr rd_mouse::model_registry rd_models;
+
 rd_mouse::mouse_variant rd_mouse::detect(){
 	
 	rd_mouse::mouse_variant mouse = rd_mouse::monostate();
+	const rd_mouse::model_registry::rd_model_entry* match = nullptr;
 
 	// libusb init
 	if( libusb_init( NULL ) < 0 )
@@ -43,25 +53,21 @@ rd_mouse::mouse_variant rd_mouse::detect(){
 		uint16_t vid = descriptor.idVendor;
 		uint16_t pid = descriptor.idProduct;
 
-		// Compare the VID and PID of the current device against the IDs of all mice
-		variant_loop< rd_mouse::mouse_variant >( [&](auto m){
-
-			if( m.has_vid_pid(vid, pid) ){
-
-				// setting the vid/pid is required for mice woth multiple ids and is ignored by all other backends
-				m.set_vid(vid);
-				m.set_pid(pid);
-
-				mouse = m;
-			}
-
-		} );
+		// Look up the VID and PID of the current device, the last detected mouse is used
+		const rd_mouse::model_registry::rd_model_entry* entry = rd_models.find( vid, pid );
+		if( entry != nullptr )
+			match = entry;
 
 	}
 	
 	// free device list, unreference devices
 	libusb_free_device_list( dev_list, 1 );
 	
+	// only the object of the detected mouse is created, with its vid/pid set
+	// (required for mice with multiple ids and ignored by all other backends)
+	if( match != nullptr )
+		mouse = rd_models.create( *match );
+	
 	// exit libusb
 	libusb_exit( NULL );
 		
@@ -71,6 +77,7 @@ rd_mouse::mouse_variant rd_mouse::detect(){
 rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 	
 	rd_mouse::mouse_variant mouse = rd_mouse::monostate();
+	const rd_mouse::model_registry::rd_model_entry* match = nullptr;
 
 	// libusb init
 	if( libusb_init( NULL ) < 0 )
@@ -93,20 +100,57 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 		uint16_t vid = descriptor.idVendor;
 		uint16_t pid = descriptor.idProduct;
 
-		// Compare the VID and PID of the current device against the IDs of all mice
-		variant_loop< rd_mouse::mouse_variant >( [&](auto m){
-
-			if( m.has_vid_pid(vid, pid) && mouse_name == m.get_name() ){
+		// Look up the VID and PID of the current device, the last detected mouse is used
+		const rd_mouse::model_registry::rd_model_entry* entry = rd_models.find( vid, pid, mouse_name );
+		if( entry != nullptr )
+			match = entry;
+		
+	}
+	
+	// free device list, unreference devices
+	libusb_free_device_list( dev_list, 1 );
+	
+	// only the object of the detected mouse is created, with its vid/pid set
+	if( match != nullptr )
+		mouse = rd_models.create( *match );
+	
+	// exit libusb
+	libusb_exit( NULL );
+		
+	return mouse;
+}
 
-				// setting the vid/pid is required for mice with multiple ids and is ignored by all other backends
-				m.set_vid(vid);
-				m.set_pid(pid);
+std::vector< rd_mouse::rd_device > rd_mouse::detect_all( const std::string& mouse_name ){
+	
+	std::vector< rd_mouse::rd_device > devices;
 
-				mouse = m;
-			}
-			
-		} );
+	// libusb init
+	if( libusb_init( NULL ) < 0 )
+		return devices;
+	
+	// get device list
+	libusb_device **dev_list; // device list
+	ssize_t num_devs = libusb_get_device_list(NULL, &dev_list);
+	
+	if( num_devs < 0 ){
+		libusb_exit( NULL );
+		return devices;
+	}
+	
+	for( ssize_t i = 0; i < num_devs; i++ ){
+		
+		// get device descriptor
+		libusb_device_descriptor descriptor;
+		libusb_get_device_descriptor( dev_list[i], &descriptor );
 		
+		rd_mouse::rd_device device;
+		device.mouse = _i_match( descriptor.idVendor, descriptor.idProduct, mouse_name );
+		
+		if( std::holds_alternative<rd_mouse::monostate>(device.mouse) )
+			continue;
+		
+		_i_locate( dev_list[i], device );
+		devices.push_back( device );
 	}
 	
 	// free device list, unreference devices
@@ -115,12 +159,149 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 	// exit libusb
 	libusb_exit( NULL );
 		
+	return devices;
+}
+
+rd_mouse::mouse_variant rd_mouse::create( const std::string& mouse_name ){
+	
+	rd_mouse::mouse_variant mouse = rd_mouse::monostate();
+	
+	for( size_t i = 0; i < model_registry::model_count(); i++ ){
+		if( model_registry::model_name( i ) != rd_mouse::monostate::get_name() && mouse_name == model_registry::model_name( i ) ){
+			mouse = model_registry::create( i );
+			break;
+		}
+	}
+	
 	return mouse;
 }
 
+rd_mouse::mouse_variant rd_mouse::_i_match( uint16_t vid, uint16_t pid, const std::string& mouse_name ){
+	
+	// Look up the VID and PID, the object is created with its vid/pid set
+	// (required for mice with multiple ids and ignored by all other backends)
+	const rd_mouse::model_registry::rd_model_entry* entry = rd_models.find( vid, pid, mouse_name );
+	if( entry == nullptr )
+		return rd_mouse::monostate();
+	
+	return rd_models.create( *entry );
+}
+
+void rd_mouse::_i_locate( libusb_device* usb_device, rd_device& device ){
+	
+	device.bus = libusb_get_bus_number( usb_device );
+	device.device = libusb_get_device_address( usb_device );
+	
+	// path on the bus, e.g. 1-3.2
+	device.path = std::to_string( device.bus );
+	uint8_t ports[8];
+	int num_ports = libusb_get_port_numbers( usb_device, ports, sizeof(ports) );
+	for( int i = 0; i < num_ports; i++ )
+		device.path += ((i == 0) ? "-" : ".") + std::to_string( ports[i] );
+}
+
+// set by the signal handler to stop watch()
+static volatile sig_atomic_t rd_watch_stop = 0;
+
+static void rd_watch_handle_signal( int signal ){
+	(void)signal;
+	rd_watch_stop = 1;
+}
+
+// a device reported by the hotplug callback, handled outside of the callback
+struct rd_arrival{
+	libusb_device* device;
+	std::chrono::steady_clock::time_point time;
+};
+
+// called by libusb when a device has been connected
+static int LIBUSB_CALL rd_hotplug_callback( libusb_context* context, libusb_device* device, libusb_hotplug_event event, void* user_data ){
+	
+	(void)context;
+	(void)event;
+	
+	// synchronous transfers are not allowed in the callback, the device is opened later
+	static_cast< std::vector< rd_arrival >* >( user_data )->push_back( { libusb_ref_device( device ), std::chrono::steady_clock::now() } );
+	
+	return 0; // keep the callback registered
+}
+
+int rd_mouse::watch( const std::string& mouse_name, arrival_handler handler ){
+	
+	// libusb init
+	if( libusb_init( NULL ) < 0 )
+		return 1;
+	
+	if( !libusb_has_capability( LIBUSB_CAP_HAS_HOTPLUG ) ){
+		libusb_exit( NULL );
+		return 1;
+	}
+	
+	// register for all devices, the vid and pid are compared with all mice
+	std::vector< rd_arrival > arrivals;
+	libusb_hotplug_callback_handle callback_handle;
+	
+	if( libusb_hotplug_register_callback( NULL, LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED, LIBUSB_HOTPLUG_ENUMERATE,
+		LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+		rd_hotplug_callback, &arrivals, &callback_handle ) != LIBUSB_SUCCESS ){
+		
+		libusb_exit( NULL );
+		return 1;
+	}
+	
+	// stop on SIGINT and SIGTERM
+	struct sigaction action;
+	std::memset( &action, 0, sizeof(action) );
+	action.sa_handler = rd_watch_handle_signal;
+	sigemptyset( &action.sa_mask );
+	sigaction( SIGINT, &action, NULL );
+	sigaction( SIGTERM, &action, NULL );
+	
+	rd_watch_stop = 0;
+	while( !rd_watch_stop ){
+		
+		// handle the devices reported since the last iteration
+		std::vector< rd_arrival > current;
+		current.swap( arrivals );
+		
+		for( auto& arrival : current ){
+			
+			libusb_device_descriptor descriptor;
+			libusb_get_device_descriptor( arrival.device, &descriptor );
+			
+			rd_mouse::rd_device device;
+			device.mouse = _i_match( descriptor.idVendor, descriptor.idProduct, mouse_name );
+			
+			if( !std::holds_alternative<rd_mouse::monostate>(device.mouse) ){
+				_i_locate( arrival.device, device );
+				handler( device, arrival.time );
+			}
+			
+			libusb_unref_device( arrival.device );
+		}
+		
+		// wait for events, the timeout allows checking rd_watch_stop
+		timeval timeout = { 1, 0 };
+		libusb_handle_events_timeout_completed( NULL, &timeout, NULL );
+	}
+	
+	// unreference devices that have not been handled
+	for( auto& arrival : arrivals )
+		libusb_unref_device( arrival.device );
+	
+	libusb_hotplug_deregister_callback( NULL, callback_handle );
+	libusb_exit( NULL );
+	
+	return 0;
+}
+
 //init libusb and open mouse
 int rd_mouse::_i_open_mouse( const uint16_t vid, const uint16_t pid ){
 	
+	// nothing to open, the transfers are simulated
+	if( _i_simulated() )
+		return 0;
+	
 	//vars
 	int res = 0;
 	
@@ -186,12 +367,18 @@ int rd_mouse::_i_open_mouse( const uint16_t vid, const uint16_t pid ){
 		return res;
 	}
 	
+	_i_attach_transport();
+	
 	return res;
 }
 
 // init libusb and open mouse by bus and device
 int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device ){
 	
+	// nothing to open, the transfers are simulated
+	if( _i_simulated() )
+		return 0;
+	
 	//vars
 	int res = 0;
 	
@@ -279,12 +466,35 @@ int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device
 		return res;
 	}
 	
+	_i_attach_transport();
+	
 	return res;
 }
 
+//usb ids of the opened mouse
+int rd_mouse::get_vid_pid( uint16_t& vid, uint16_t& pid ){
+	
+	if( _i_handle == nullptr )
+		return 1;
+	
+	libusb_device_descriptor descriptor;
+	if( libusb_get_device_descriptor( libusb_get_device( _i_handle ), &descriptor ) != 0 )
+		return 1;
+	
+	vid = descriptor.idVendor;
+	pid = descriptor.idProduct;
+	
+	return 0;
+}
+
 //close mouse
 int rd_mouse::_i_close_mouse(){
 	
+	if( _i_simulated() )
+		return 0;
+	
+	_i_get_transport().set_handle( nullptr );
+	
 	//release interfaces 0, 1 and 2
 	libusb_release_interface( _i_handle, 0 );
 	libusb_release_interface( _i_handle, 1 );
@@ -306,155 +516,879 @@ int rd_mouse::_i_close_mouse(){
 		libusb_attach_kernel_driver( _i_handle, 2);
 	}
 	
+	//close device
+	if( _i_handle != nullptr )
+		libusb_close( _i_handle );
+	_i_handle = nullptr;
+	
 	//exit libusb
 	libusb_exit( NULL );
 	
 	return 0;
 }
 
-//decode macro bytecode
-int rd_mouse::_i_decode_macro( const std::vector< uint8_t >& macro_bytes, std::ostream& output, const std::string& prefix, size_t offset ){
+//read memory of the mouse
+int rd_mouse::_i_read_memory( const uint8_t* rows, size_t row_count, size_t row_length, uint16_t value, std::map< uint16_t, uint8_t >& memory ){
 	
-	// valid offset ?
-	if( offset >= macro_bytes.size() )
-		offset = 0;
+	std::vector< rd_packet > packets;
+	for( size_t i = 0; i < row_count; i++ )
+		packets.emplace_back( value, rows + i*row_length, row_length );
+	
+	return _i_read_memory( packets, memory );
+}
+
+int rd_mouse::_i_read_memory( const std::vector< rd_packet >& rows, std::map< uint16_t, uint8_t >& memory ){
+	
+	std::vector< uint8_t > buffer_out, buffer_in;
 	
-	for( size_t i = offset; i < macro_bytes.size(); ){
+	for( auto& row : rows ){
 		
-		bool unknown_code = false;
+		// control out
+		buffer_out = row.data;
+		if( buffer_out.size() < 8 || _i_control_transfer( 0x21, 0x09, row.value, 0x0002, buffer_out.data(), buffer_out.size() ) < 0 )
+			return 1;
 		
-		// mouse buttons ( 0x81 = down, 0x01 = up )
-		if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x01 )
-			output << prefix << "down\tmouse_left\n";
-		else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x02 )
-			output << prefix << "down\tmouse_right\n";
-		else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x04 )
-			output << prefix << "down\tmouse_middle\n";
-		else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x01 )
-			output << prefix << "up\tmouse_left\n";
-		else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x02 )
-			output << prefix << "up\tmouse_right\n";
-		else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x04 )
-			output << prefix << "up\tmouse_middle\n";
-		else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x10 )
-			output << prefix << "down\tmouse_forward\n";
-		else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x10 )
-			output << prefix << "up\tmouse_forward\n";
-		else if( macro_bytes[i] == 0x81 && macro_bytes[i+1] == 0x08 )
-			output << prefix << "down\tmouse_backward\n";
-		else if( macro_bytes[i] == 0x01 && macro_bytes[i+1] == 0x08 )
-			output << prefix << "up\tmouse_backward\n";
-		else if( macro_bytes[i] == 0x81 || macro_bytes[i] == 0x01 )
-			unknown_code = true; // unknown code
-		
-		// keyboard key ( 0x84 = down, 0x04 = up )
-		else if( macro_bytes[i] == 0x84 || macro_bytes[i] == 0x04 ){
+		// only read requests are answered
+		if( buffer_out[1] != 0xf2 )
+			continue;
+		
+		// control in
+		buffer_in.assign( buffer_out.size(), 0 );
+		int num_bytes_in = _i_control_transfer( 0xa1, 0x01, row.value, 0x0002, buffer_in.data(), buffer_in.size() );
+		
+		// store data, the response contains the requested bytes starting at buffer_in[8]
+		uint16_t address = buffer_out[2] + (buffer_out[3] << 8);
+		size_t length = buffer_out[4];
+		
+		if( num_bytes_in < 0 || (size_t)num_bytes_in < 8+length )
+			continue;
+		
+		for( size_t j = 0; j < length; j++ )
+			memory[address+j] = buffer_in[8+j];
+	}
+	
+	return 0;
+}
+
+//read the memory written by write requests
+int rd_mouse::_i_read_written( const std::vector< const rd_packet* >& packets, std::map< uint16_t, uint8_t >& memory ){
+	
+	// start and end of a sequence of requests
+	const uint8_t start[16] = { 0x02, 0xf5, 0x00 }, end[16] = { 0x02, 0xf5, 0x01 };
+	
+	// written ranges (first address, end address), sorted
+	std::vector< std::pair< uint32_t, uint32_t > > ranges;
+	for( auto packet : packets ){
+		if( packet->data.size() < 8 || packet->data[1] != 0xf3 || 8 + (size_t)packet->data[4] > packet->data.size() )
+			continue;
+		uint32_t address = packet->data[2] + (packet->data[3] << 8);
+		ranges.emplace_back( address, address + packet->data[4] );
+	}
+	std::sort( ranges.begin(), ranges.end() );
+	
+	// merge ranges into read requests of up to _c_verify_read_length bytes, short reads use 16 byte rows
+	std::vector< rd_packet > requests;
+	requests.emplace_back( 0x0302, start, 16 );
+	
+	for( size_t i = 0; i < ranges.size(); ){
+		
+		uint32_t first = ranges[i].first, last = ranges[i].second;
+		for( i++; i < ranges.size() && ranges[i].second - first <= _c_verify_read_length; i++ )
+			last = std::max( last, ranges[i].second );
+		
+		// a single packet may be longer than a read request
+		for( uint32_t address = first; address < last; address += _c_verify_read_length ){
 			
-			bool found_name = false;
-			std::string key = "";
+			uint8_t length = std::min< uint32_t >( last - address, _c_verify_read_length );
+			uint8_t row[64] = { 0x03, 0xf2, (uint8_t)(address & 0xff), (uint8_t)((address >> 8) & 0xff), length };
 			
-			// iterate over _c_keyboard_key_values
-			for( auto keycode : _c_keyboard_key_values ){
-				
-				if( keycode.second == macro_bytes[i+1] ){
-					key = keycode.first;
-					found_name = true;
-					break;
-				}
-				
+			if( length <= 8 ){
+				row[0] = 0x02;
+				requests.emplace_back( 0x0302, row, 16 );
+			} else{
+				requests.emplace_back( 0x0303, row, 64 );
+			}
+		}
+	}
+	
+	requests.emplace_back( 0x0302, end, 16 );
+	
+	return _i_read_memory( requests, memory );
+}
+
+//check if a write request would not change memory
+bool rd_mouse::_i_write_unchanged( const uint8_t* packet, size_t packet_length, const std::map< uint16_t, uint8_t >& memory ){
+	
+	// only write requests can be skipped
+	if( packet_length < 8 || packet[1] != 0xf3 )
+		return false;
+	
+	uint16_t address = packet[2] + (packet[3] << 8);
+	size_t length = packet[4];
+	
+	if( 8+length > packet_length )
+		return false;
+	
+	for( size_t i = 0; i < length; i++ ){
+		auto byte = memory.find( address+i );
+		if( byte == memory.end() || byte->second != packet[8+i] )
+			return false;
+	}
+	
+	return true;
+}
+
+void rd_mouse::begin_operation(){
+	
+	if( _i_transfer_error != LIBUSB_ERROR_NO_DEVICE )
+		_i_transfer_error = 0;
+	
+	_i_operation_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( _i_operation_timeout );
+}
+
+unsigned int rd_mouse::_i_remaining_time(){
+	
+	if( _i_operation_timeout == 0 )
+		return _i_transfer_timeout;
+	
+	auto remaining = std::chrono::duration_cast< std::chrono::milliseconds >( _i_operation_deadline - std::chrono::steady_clock::now() ).count();
+	
+	if( remaining <= 0 )
+		return 0;
+	
+	return std::min( (unsigned int)remaining, _i_transfer_timeout );
+}
+
+int rd_mouse::_i_transfer( const std::function< int( unsigned int ) >& transfer ){
+	
+	// the mouse is gone, fail without waiting for a timeout
+	if( _i_transfer_error == LIBUSB_ERROR_NO_DEVICE )
+		return LIBUSB_ERROR_NO_DEVICE;
+	
+	int ret = LIBUSB_ERROR_TIMEOUT;
+	
+	for( unsigned int attempt = 0; attempt < _c_transfer_attempts; attempt++ ){
+		
+		// retry with backoff if the mouse was busy or stalled the request
+		if( attempt > 0 ){
+			unsigned int delay = std::min( _c_retry_delay << (attempt-1), _i_remaining_time() );
+			std::this_thread::sleep_for( std::chrono::milliseconds( delay ) );
+		}
+		
+		// a timeout of 0 means unlimited for libusb
+		unsigned int timeout = _i_remaining_time();
+		if( timeout == 0 ){
+			ret = LIBUSB_ERROR_TIMEOUT;
+			break;
+		}
+		
+		ret = transfer( timeout );
+		
+		if( ret != LIBUSB_ERROR_BUSY && ret != LIBUSB_ERROR_PIPE )
+			break;
+	}
+	
+	// keep the first error of the operation, but always remember that the mouse is gone
+	if( ret < 0 && ( _i_transfer_error == 0 || ret == LIBUSB_ERROR_NO_DEVICE ) )
+		_i_transfer_error = ret;
+	
+	return ret;
+}
+
+int rd_mouse::_i_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint8_t* data, uint16_t length ){
+	
+	return _i_transfer( [&]( unsigned int timeout ){
+		return _i_get_transport().control_transfer( request_type, request, value, index, data, length, timeout );
+	} );
+}
+
+int rd_mouse::_i_interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred ){
+	
+	return _i_transfer( [&]( unsigned int timeout ){
+		int received = 0;
+		int ret = _i_get_transport().interrupt_transfer( endpoint, data, length, &received, timeout );
+		if( transferred != NULL )
+			*transferred = received;
+		return ( ret < 0 ) ? ret : received;
+	} );
+}
+
+// state of a sequence of asynchronous transfers, shared with the completion handlers,
+// which may run in the libusb event loop of another thread (see perform_actions_all())
+struct rd_transfer_sequence{
+	std::mutex lock;
+	unsigned int in_flight = 0;
+	int failed = 0;
+	int error = 0; // libusb error code of the first failed transfer
+	
+	struct counters{
+		unsigned int in_flight;
+		int failed;
+		int error;
+	};
+};
+
+//send packets
+int rd_mouse::_i_write_packets( const std::vector< rd_packet >& packets ){
+	
+	// only prepare the packets, see set_packet_capture()
+	if( _i_packet_capture != nullptr ){
+		_i_packet_capture->insert( _i_packet_capture->end(), packets.begin(), packets.end() );
+		return 0;
+	}
+	
+	// write_changes() can no longer compare with the written packets
+	if( !_i_writing_changes ){
+		_i_written_settings.clear();
+		for( auto& macro : _i_written_macros )
+			macro.clear();
+	}
+	
+	rd_transport& transport = _i_get_transport();
+	
+	// blocking transfers, also used if the transport does not support asynchronous transfers
+	if( _i_transfer_window <= 1 || !transport.supports_async() ){
+		
+		int failed = 0;
+		std::vector< uint8_t > buffer;
+		
+		for( size_t i = 0; i < packets.size(); i++ ){
+			
+			// the remaining packets can not be sent either
+			if( _i_transfer_error == LIBUSB_ERROR_NO_DEVICE || _i_remaining_time() == 0 )
+				return failed + (int)(packets.size() - i);
+			
+			buffer = packets[i].data;
+			if( _i_control_transfer( packets[i].request_type, packets[i].request, packets[i].value, packets[i].index,
+				buffer.empty() ? NULL : buffer.data(), buffer.size() ) < 0 )
+				failed++;
+		}
+		
+		return failed;
+	}
+	
+	// asynchronous transfers, completed in order
+	rd_transfer_sequence sequence;
+	size_t next = 0;
+	bool submit_failed = false;
+	
+	auto completed = [&sequence]( int result ){
+		
+		std::lock_guard< std::mutex > guard( sequence.lock );
+		sequence.in_flight--;
+		if( result < 0 ){
+			sequence.failed++;
+			// a lost mouse is always recorded
+			if( sequence.error == 0 || result == LIBUSB_ERROR_NO_DEVICE )
+				sequence.error = result;
+		}
+	};
+	
+	// a copy of the state, taken with the lock held
+	auto state = [&sequence](){
+		std::lock_guard< std::mutex > guard( sequence.lock );
+		rd_transfer_sequence::counters counters = { sequence.in_flight, sequence.failed, sequence.error };
+		return counters;
+	};
+	
+	while( (next < packets.size() && !submit_failed) || state().in_flight > 0 ){
+		
+		// fill the window
+		while( next < packets.size() && !submit_failed && state().in_flight < _i_transfer_window ){
+			
+			// stop when the mouse is gone or the time limit has passed
+			unsigned int timeout = _i_remaining_time();
+			if( state().error == LIBUSB_ERROR_NO_DEVICE || _i_transfer_error == LIBUSB_ERROR_NO_DEVICE || timeout == 0 ){
+				submit_failed = true;
+				break;
 			}
 			
-			// if key found, print key action
-			if( found_name ){
-				
-				if( macro_bytes[i] == 0x84 ) // keyboard key down
-					output << prefix << "down\t" << key << "\n";
-				else if( macro_bytes[i] == 0x04 ) // keyboard key up
-					output << prefix << "up\t" << key << "\n";
-				else // failsafe
-					unknown_code = true;
-				
-			} else{ // unknown key
-				unknown_code = true;
+			// counted before submitting, the transfer may complete before submit_control_transfer() returns
+			{
+				std::lock_guard< std::mutex > guard( sequence.lock );
+				sequence.in_flight++;
 			}
 			
+			const rd_packet& packet = packets[next];
+			int submitted = transport.submit_control_transfer( packet.request_type, packet.request, packet.value, packet.index,
+				packet.data.data(), packet.data.size(), timeout, completed );
+			
+			if( submitted != 0 ){
+				std::lock_guard< std::mutex > guard( sequence.lock );
+				sequence.in_flight--;
+				if( sequence.error == 0 || submitted == LIBUSB_ERROR_NO_DEVICE )
+					sequence.error = submitted;
+				submit_failed = true;
+				break;
+			}
+			
+			next++;
 		}
 		
-		// delay
-		else if( macro_bytes[i] == 0x06 ){
-			output << prefix << "delay\t" << (int)macro_bytes[i+1] << "\n";
+		// wait for completions, the transfers time out after _i_transfer_timeout so this always terminates
+		if( state().in_flight > 0 )
+			transport.wait();
+	}
+	
+	// all transfers have completed, no handler accesses the state anymore
+	rd_transfer_sequence::counters result = state();
+	
+	// asynchronous transfers are not retried, the error is reported like for blocking transfers
+	if( result.error < 0 && ( _i_transfer_error == 0 || result.error == LIBUSB_ERROR_NO_DEVICE ) )
+		_i_transfer_error = result.error;
+	else if( next < packets.size() && _i_transfer_error == 0 )
+		_i_transfer_error = ( _i_remaining_time() == 0 ) ? LIBUSB_ERROR_TIMEOUT : LIBUSB_ERROR_NO_MEM;
+	
+	return result.failed + (int)(packets.size() - next);
+}
+
+//send packets and verify the written memory
+int rd_mouse::_i_write_verified( const std::vector< rd_packet >& packets ){
+	
+	int ret = _i_write_packets( packets );
+	
+	if( !_i_verify || _i_packet_capture != nullptr || ret != 0 )
+		return ret;
+	
+	// write requests that can be read back
+	std::vector< const rd_packet* > pending;
+	for( auto& packet : packets ){
+		if( packet.verify && packet.request_type == 0x21 && packet.data.size() >= 8 && packet.data[1] == 0xf3 &&
+			8 + (size_t)packet.data[4] <= packet.data.size() && packet.data[4] > 0 )
+			pending.push_back( &packet );
+	}
+	
+	// start and end of a sequence of requests
+	const uint8_t start[16] = { 0x02, 0xf5, 0x00 }, end[16] = { 0x02, 0xf5, 0x01 };
+	
+	if( _i_resent_packets < 0 )
+		_i_resent_packets = 0;
+	
+	for( int attempt = 0; attempt < _c_verify_attempts && !pending.empty(); attempt++ ){
+		
+		// read back
+		std::map< uint16_t, uint8_t > memory;
+		if( _i_read_written( pending, memory ) != 0 )
+			return (int)pending.size();
+		
+		// re-send the packets whose memory differs, framed like a write
+		std::vector< const rd_packet* > mismatching;
+		std::vector< rd_packet > resend;
+		resend.emplace_back( 0x0302, start, 16 );
+		
+		for( auto packet : pending ){
+			if( !_i_write_unchanged( packet->data.data(), packet->data.size(), memory ) ){
+				mismatching.push_back( packet );
+				resend.push_back( *packet );
+			}
 		}
 		
-		// mouse movement
-		else if( macro_bytes[i] == 0x02 ){
+		resend.emplace_back( 0x0302, end, 16 );
+		pending.swap( mismatching );
+		
+		// the last readback only reports the mismatches
+		if( pending.empty() || attempt+1 == _c_verify_attempts )
+			break;
+		
+		_i_resent_packets += (int)pending.size();
+		if( _i_write_packets( resend ) != 0 )
+			return (int)pending.size();
+	}
+	
+	return (int)pending.size();
+}
+
+//write the changed settings
+int rd_mouse::_i_write_changes( const std::function< int() >& settings, const std::function< int( int ) >& macro,
+	const std::function< int() >& profile, bool rows ){
+	
+	// the packets of an image are always complete
+	if( _i_packet_capture != nullptr )
+		rows = false;
+	
+	int ret = 0, r = 0;
+	_i_writing_changes = true;
+	
+	// settings
+	if( _i_changes.any_profile() ){
+		
+		if( rows ){
 			
-			// left/right
-			if( macro_bytes[i+2] == 0x00 ){
+			// a differential write compares with the memory of the mouse, not with the packets written
+			// last time, these can be stale if another program or daemon request changed the mouse
+			if( _i_differential_write )
+				_i_written_settings.clear();
 			
-				// left
-				if( macro_bytes[i+1] >= 0x88 )
-					output << prefix << "move_left\t" << (int)((int8_t)macro_bytes[i+1] * (-1)) << "\n";
-				
-				// right
-				else if( macro_bytes[i+1] <= 0x78 )
-					output << prefix << "move_right\t" << (int)macro_bytes[i+1] << "\n";
-				
-				else
-					unknown_code = true;
-				
+			int skipped = 0;
+			r = _i_write_changed_rows( settings, _i_written_settings, &skipped );
+			if( _i_differential_write )
+				_i_skipped_packets = skipped;
+		} else{
+			r = settings();
+		}
+		
+		if( r == 0 )
+			_i_changes.profiles.fill( false );
+		ret += r;
+	}
+	
+	// macros
+	for( int i = 0; i < 15; i++ ){
+		
+		if( !_i_changes.macros[i] )
+			continue;
+		
+		r = rows ? _i_write_changed_rows( [&](){ return macro( i+1 ); }, _i_written_macros[i], nullptr ) : macro( i+1 );
+		
+		if( r == 0 )
+			_i_changes.macros[i] = false;
+		ret += r;
+	}
+	
+	// active profile, sent last like by the cli
+	if( _i_changes.profile ){
+		
+		r = profile();
+		
+		if( r == 0 )
+			_i_changes.profile = false;
+		ret += r;
+	}
+	
+	_i_writing_changes = false;
+	return ret;
+}
+
+//send the changed rows of a section
+int rd_mouse::_i_write_changed_rows( const std::function< int() >& writer, std::vector< rd_packet >& written, int* skipped ){
+	
+	// prepare the packets, a differential write would read the mouse
+	std::vector< rd_packet > packets;
+	bool differential_write = _i_differential_write;
+	_i_differential_write = false;
+	set_packet_capture( &packets );
+	int ret = writer();
+	set_packet_capture( nullptr );
+	_i_differential_write = differential_write;
+	
+	if( ret != 0 )
+		return ret;
+	
+	auto same = []( const rd_packet& a, const rd_packet& b ){
+		return a.request_type == b.request_type && a.request == b.request && a.value == b.value &&
+			a.index == b.index && a.data == b.data;
+	};
+	auto write_request = []( const rd_packet& packet ){
+		return packet.request_type == 0x21 && packet.data.size() >= 8 && packet.data[1] == 0xf3;
+	};
+	
+	// can only the changed rows be sent? Only unchanged write requests are left out, the other
+	// packets (start, end and commit rows) are kept in their position, like with a differential write
+	bool rows = !written.empty() && written.size() == packets.size();
+	bool any_changed = false;
+	int unchanged = 0;
+	
+	std::vector< rd_packet > changed;
+	for( size_t i = 0; rows && i < packets.size(); i++ ){
+		
+		bool same_packet = same( packets[i], written[i] );
+		
+		if( !write_request( packets[i] ) ){
+			rows = same_packet;
+			changed.push_back( packets[i] );
+		} else if( same_packet ){
+			unchanged++;
+		} else{
+			any_changed = true;
+			changed.push_back( packets[i] );
+		}
+	}
+	
+	if( rows ){
+		
+		if( skipped != nullptr )
+			*skipped = unchanged;
+		
+		// nothing changed
+		if( !any_changed )
+			return 0;
+		
+		ret = _i_write_verified( changed );
+		
+	} else{
+		
+		// send all packets, with a differential write if enabled
+		ret = writer();
+		
+		if( skipped != nullptr )
+			*skipped = _i_skipped_packets;
+	}
+	
+	// the state of the mouse is unknown after a failed write
+	if( ret == 0 )
+		written.swap( packets );
+	else
+		written.clear();
+	
+	return ret;
+}
+
+//send rows of the settings
+int rd_mouse::_i_write_settings_rows( const std::vector< rd_packet >& packets ){
+	
+	_i_writing_changes = true;
+	int ret = _i_write_verified( packets );
+	_i_writing_changes = false;
+	
+	if( _i_packet_capture != nullptr )
+		return ret;
+	
+	// the state of the mouse is unknown after a failed write
+	if( ret != 0 ){
+		_i_written_settings.clear();
+		return ret;
+	}
+	
+	// replace the written rows, a row is identified by the report id, the request and the address
+	for( auto& packet : packets ){
+		
+		if( packet.data.size() < 8 || packet.data[1] != 0xf3 )
+			continue;
+		
+		for( auto& written : _i_written_settings ){
+			if( written.value == packet.value && written.data.size() == packet.data.size() &&
+				std::equal( packet.data.begin(), packet.data.begin()+5, written.data.begin() ) )
+				written.data = packet.data;
+		}
+	}
+	
+	return 0;
+}
+
+//print the responses of a snapshot as a hexdump
+void rd_mouse::_i_dump_snapshot( const rd_device_snapshot& snapshot, std::ostream& output ){
+	
+	for( size_t part = 0; part < snapshot.parts.size(); part++ ){
+		
+		output << "Part " << part+1 << ":\n\n";
+		
+		for( size_t i = 0; i < snapshot.parts[part].size(); i++ ){
+			
+			const std::vector< uint8_t >& response = snapshot.parts[part][i];
+			int length = std::min( snapshot.lengths[part][i], (int)response.size() );
+			
+			// hexdump
+			if( length > 0 ){
+				output << std::hex;
+				for( int j = 0; j < length; j++ ){
+					output << std::setfill('0') << std::setw(2) << (int)response[j] << " ";
+				}
+				output << "\n\n" << std::dec << std::setw(0) << std::setfill(' ');
 			}
+		}
+	}
+}
+
+int rd_mouse::rd_read_selection::parse( const std::string& sections ){
+	
+	set_all( false );
+	
+	std::stringstream sections_stream( sections );
+	std::string section;
+	bool selected = false;
+	
+	while( std::getline( sections_stream, section, ',' ) ){
+		
+		if( section.empty() ){
+			return 1;
+		} else if( section == "profile" ){
+			active_profile = true;
+		} else if( section == "battery" ){
+			battery = true;
+		} else if( section == "macros" ){
+			macros.fill( true );
+		} else if( section.rfind( "macros:", 0 ) == 0 ){
+			
+			// macro number 1-15
+			int macro = 0;
+			const char* first = section.data() + 7;
+			const char* last = section.data() + section.size();
+			auto result = std::from_chars( first, last, macro );
+			if( first == last || result.ec != std::errc() || result.ptr != last || macro < 1 || macro > 15 )
+				return 1;
+			
+			macros[macro-1] = true;
+			
+		} else{
 			
-			// up down
-			else if( macro_bytes[i+1] == 0x00 ){
+			// [profile⟨1-5⟩.]⟨section⟩ or profile⟨1-5⟩
+			std::array< bool, 5 > profiles;
+			profiles.fill( true );
+			std::string name = section;
+			
+			if( section.rfind( "profile", 0 ) == 0 ){
 				
-				// up
-				if( (int)macro_bytes[i+2] >= 0x88 )
-					output << prefix << "move_up\t" << (int)((int8_t)macro_bytes[i+2] * (-1)) << "\n";
+				if( section.size() < 8 || section[7] < '1' || section[7] > '5' )
+					return 1;
 				
-				// down
-				else if( macro_bytes[i+2] <= 0x78 )
-					output << prefix << "move_down\t" << (int)macro_bytes[i+2] << "\n";
+				profiles.fill( false );
+				profiles[section[7]-'1'] = true;
 				
+				if( section.size() == 8 )
+					name = "";
+				else if( section[8] == '.' && section.size() > 9 )
+					name = section.substr( 9 );
 				else
-					unknown_code = true;
-				
+					return 1;
 			}
 			
-			else
-				unknown_code = true;
+			for( int i = 0; i < 5; i++ ){
+				
+				if( !profiles[i] )
+					continue;
+				
+				if( name == "" || name == "led" )
+					led[i] = true;
+				if( name == "" || name == "report_rate" )
+					report_rate[i] = true;
+				if( name == "" || name == "dpi" )
+					dpi[i] = true;
+				if( name == "" || name == "buttons" )
+					buttons[i] = true;
+			}
 			
+			if( name != "" && name != "led" && name != "report_rate" && name != "dpi" && name != "buttons" )
+				return 1;
 		}
+		
+		selected = true;
+	}
+	
+	return selected ? 0 : 1;
+}
 
-		// repeat
-		else if( macro_bytes[i] == 0xff ){
-			output << prefix << "repeat\t" << (int)macro_bytes[i+1] + (int)macro_bytes[i+2]*256 << "\n";
-		}
+std::array< std::vector< bool >, 3 > rd_mouse::_i_wired_read_mask( const rd_read_selection& selection,
+	size_t responses1, size_t responses2, size_t responses3, size_t buttons ){
+	
+	// everything includes the responses that are not decoded (e.g. part 2 after the macros)
+	bool everything = selection.everything();
+	std::array< std::vector< bool >, 3 > mask = {
+		std::vector< bool >( responses1, everything ),
+		std::vector< bool >( responses2, everything ),
+		std::vector< bool >( responses3, everything )
+	};
+	
+	auto set = [&mask]( size_t part, size_t response ){
+		if( response < mask[part].size() )
+			mask[part][response] = true;
+	};
+	
+	if( selection.active_profile )
+		set( 0, 0 );
+	
+	for( size_t i = 0; i < 5; i++ ){
+		
+		if( selection.led[i] )
+			set( 0, i+1 );
+		
+		// report rates of profiles 1-3 and 4-5 share a response
+		if( selection.report_rate[i] )
+			set( 0, (i < 3) ? 6 : 7 );
+		
+		if( selection.dpi[i] )
+			set( 1, i );
 		
-		// padding (increment by one until a code appears)
-		else if( macro_bytes[i] == 0x00 ){
-			i++;
+		if( selection.buttons[i] ){
+			for( size_t j = 0; j < buttons; j++ )
+				set( 2, j+(buttons*i) );
+		}
+	}
+	
+	// four responses per macro after the DPI levels
+	for( size_t i = 0; i < 15; i++ ){
+		if( selection.macros[i] ){
+			for( size_t j = 0; j < 4; j++ )
+				set( 1, 5+(4*i)+j );
 		}
+	}
+	
+	return mask;
+}
+
+int rd_mouse::_i_decode_macro( const std::vector< uint8_t >& macro_bytes, std::ostream& output, const std::string& prefix, size_t offset ){
+	
+	// valid offset ?
+	if( offset >= macro_bytes.size() )
+		offset = 0;
+	
+	std::string buffer;
+	int result = _i_decode_macro( macro_bytes.data() + offset, macro_bytes.size() - offset, buffer, prefix );
+	output << buffer;
+	
+	return result;
+}
+
+int rd_mouse::_i_decode_macro( const uint8_t* macro_bytes, size_t size, std::string& output, const std::string& prefix ){
+	
+	// a handler decodes one 3 byte code, returns false if the code is unknown
+	typedef bool (*rd_macro_handler)( const uint8_t* code, std::string& output, const std::string& prefix );
+	
+	auto append_number = []( std::string& output, int number, int base ){
+		char digits[16];
+		output.append( digits, std::to_chars( digits, digits + sizeof(digits), number, base ).ptr );
+	};
+	
+	// names of the mouse buttons, indexed by the second byte
+	static const std::array< std::string_view, 256 > mouse_buttons = [](){
+		std::array< std::string_view, 256 > names = {};
+		names[0x01] = "mouse_left";
+		names[0x02] = "mouse_right";
+		names[0x04] = "mouse_middle";
+		names[0x08] = "mouse_backward";
+		names[0x10] = "mouse_forward";
+		return names;
+	}();
+	
+	// dispatch table, indexed by the first byte, nullptr for unknown codes
+	static const std::array< rd_macro_handler, 256 > handlers = [](){
 		
-		// unknown code
-		else{
-			unknown_code = true;
+		std::array< rd_macro_handler, 256 > table = {};
+		
+		// mouse buttons ( 0x81 = down, 0x01 = up )
+		table[0x81] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			if( mouse_buttons[code[1]].empty() )
+				return false;
+			output.append( prefix ).append( "down\t" ).append( mouse_buttons[code[1]] ).append( "\n" );
+			return true;
+		};
+		table[0x01] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			if( mouse_buttons[code[1]].empty() )
+				return false;
+			output.append( prefix ).append( "up\t" ).append( mouse_buttons[code[1]] ).append( "\n" );
+			return true;
+		};
+		
+		// keyboard keys ( 0x84 = down, 0x04 = up )
+		table[0x84] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			const auto* key = _c_keyboard_key_values.find_value( code[1] );
+			if( key == nullptr )
+				return false;
+			output.append( prefix ).append( "down\t" ).append( key->name ).append( "\n" );
+			return true;
+		};
+		table[0x04] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			const auto* key = _c_keyboard_key_values.find_value( code[1] );
+			if( key == nullptr )
+				return false;
+			output.append( prefix ).append( "up\t" ).append( key->name ).append( "\n" );
+			return true;
+		};
+		
+		// delay
+		table[0x06] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			char digits[4];
+			output.append( prefix ).append( "delay\t" );
+			output.append( digits, std::to_chars( digits, digits + sizeof(digits), code[1] ).ptr ).append( "\n" );
+			return true;
+		};
+		
+		// mouse movement, one axis per code
+		table[0x02] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			
+			std::string_view direction;
+			uint8_t distance;
+			
+			if( code[2] == 0x00 && code[1] >= 0x88 ){
+				direction = "move_left\t";
+				distance = -(int8_t)code[1];
+			} else if( code[2] == 0x00 && code[1] <= 0x78 ){
+				direction = "move_right\t";
+				distance = code[1];
+			} else if( code[1] == 0x00 && code[2] >= 0x88 ){
+				direction = "move_up\t";
+				distance = -(int8_t)code[2];
+			} else if( code[1] == 0x00 && code[2] <= 0x78 ){
+				direction = "move_down\t";
+				distance = code[2];
+			} else{
+				return false;
+			}
+			
+			char digits[4];
+			output.append( prefix ).append( direction );
+			output.append( digits, std::to_chars( digits, digits + sizeof(digits), distance ).ptr ).append( "\n" );
+			return true;
+		};
+		
+		// repeat, little endian count
+		table[0xff] = []( const uint8_t* code, std::string& output, const std::string& prefix ){
+			char digits[8];
+			output.append( prefix ).append( "repeat\t" );
+			output.append( digits, std::to_chars( digits, digits + sizeof(digits), code[1] + code[2]*256 ).ptr ).append( "\n" );
+			return true;
+		};
+		
+		return table;
+	}();
+	
+	int result = 0;
+	
+	for( size_t i = 0; i < size; ){
+		
+		// padding, skip
+		if( macro_bytes[i] == 0x00 ){
+			i += 4;
+			continue;
 		}
 		
+		// the last code may be truncated, missing bytes are 0x00
+		uint8_t code[3] = { macro_bytes[i], 0x00, 0x00 };
+		if( i+1 < size )
+			code[1] = macro_bytes[i+1];
+		if( i+2 < size )
+			code[2] = macro_bytes[i+2];
+		
+		rd_macro_handler handler = handlers[code[0]];
+		
 		// if unknown code, print message + code
-		if( unknown_code ){
-			output << prefix << "unknown, please report as bug: ";
-			output << std::hex << (int)macro_bytes[i] << " ";
-			output << std::hex << (int)macro_bytes[i+1] << " ";
-			output << std::hex << (int)macro_bytes[i+2];
-			output << std::dec << "\n";
+		if( handler == nullptr || !handler( code, output, prefix ) ){
+			output.append( prefix ).append( "unknown, please report as bug: " );
+			append_number( output, code[0], 16 );
+			output.append( " " );
+			append_number( output, code[1], 16 );
+			output.append( " " );
+			append_number( output, code[2], 16 );
+			output.append( "\n" );
+			result = 1;
 		}
 		
 		// increment (each code is 3 bytes long)
-		i+=3;
+		i += 3;
 		
 	}
 	
-	return 0;
+	return result;
+}
+
+int rd_mouse::_i_decode_macros( const std::array< std::array< uint8_t, 256 >, 15 >& macro_data, std::ostream& output, size_t offset ){
+	
+	int result = 0;
+	std::string buffer = "\n# Macros\n";
+	
+	for( size_t i = 0; i < macro_data.size(); i++ ){
+		
+		// is macro not defined ?
+		if( macro_data[i][offset] == 0 && macro_data[i][offset+1] == 0 && macro_data[i][offset+2] == 0 )
+			continue;
+		
+		buffer.append( "\n;## macro" ).append( std::to_string(i+1) ).append( "\n" );
+		result |= _i_decode_macro( macro_data[i].data() + offset, macro_data[i].size() - offset, buffer, ";# " );
+		
+	}
+	
+	output << buffer;
+	return result;
 }
 
 int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::istream& input, const size_t offset ){
@@ -482,22 +1416,24 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 		value1 = line.substr(0, position);
 		value2 = line.substr(position+1);
 		
+		const auto* keycode = _c_keyboard_key_values.find( value2 );
+		
 		// keyboard key down
-		if( value1 == "down" && _c_keyboard_key_values.find(value2) != _c_keyboard_key_values.end() ){
+		if( value1 == "down" && keycode != nullptr ){
 			
 			macro_bytes[data_offset] = 0x84;
-			macro_bytes[data_offset+1] = _c_keyboard_key_values[value2];
+			macro_bytes[data_offset+1] = keycode->value;
 			data_offset += 3;
 		
 		// keyboard key up
-		} else if( value1 == "up" && _c_keyboard_key_values.find(value2) != _c_keyboard_key_values.end() ){
+		} else if( value1 == "up" && keycode != nullptr ){
 			
 			macro_bytes[data_offset] = 0x04;
-			macro_bytes[data_offset+1] = _c_keyboard_key_values[value2];
+			macro_bytes[data_offset+1] = keycode->value;
 			data_offset += 3;
 		
 		// mouse button down	
-		} else if( value1 == "down" && _c_keyboard_key_values.find(value2) == _c_keyboard_key_values.end() ){
+		} else if( value1 == "down" && keycode == nullptr ){
 			
 			if( value2 == "mouse_left" ){
 				macro_bytes[data_offset] = 0x81;
@@ -522,7 +1458,7 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			}
 		
 		// mouse button up
-		} else if( value1 == "up" && _c_keyboard_key_values.find(value2) == _c_keyboard_key_values.end() ){
+		} else if( value1 == "up" && keycode == nullptr ){
 			
 			if( value2 == "mouse_left" ){
 				macro_bytes[data_offset] = 0x01;
@@ -636,17 +1572,9 @@ int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std
 			output << "mouse_middle:";
 		else{
 			
-			// iterate over _c_keyboard_key_values
-			for( auto keycode : _c_keyboard_key_values ){
-				
-				if( keycode.second == bytes.at(1) ){
-					
-					output << keycode.first;
-					break;
-					
-				}
-				
-			}
+			const auto* keycode = _c_keyboard_key_values.find_value( bytes.at(1) );
+			if( keycode != nullptr )
+				output << keycode->name;
 			output << ":";
 		}
 		
@@ -675,7 +1603,7 @@ int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std
 	} else if( bytes.at(0) == 0x9a && bytes.at(1) == 0x01 ){
 		
 		// iterate over _c_snipe_dpi_values
-		for( auto dpi : _c_snipe_dpi_values ){
+		for( auto& dpi : _c_snipe_dpi_values ){
 			
 			if( dpi.second == bytes.at(2) && dpi.second == bytes.at(3) ){
 				
@@ -714,60 +1642,36 @@ int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std
 	// keyboard key
 	} else if( bytes.at(0) == 0x90 ){
 		
-		// iterate over _c_keyboard_key_values
-		for( auto keycode : _c_keyboard_key_values ){
-			
-			if( keycode.second == bytes.at(2) ){
-				
-				output << keycode.first;
-				found_name = true;
-				break;
-				
-			}
-			
+		const auto* keycode = _c_keyboard_key_values.find_value( bytes.at(2) );
+		if( keycode != nullptr ){
+			output << keycode->name;
+			found_name = true;
 		}
 		
 	// modifiers + keyboard key
 	} else if( bytes.at(0) == 0x8f ){
 		
 		// iterate over _c_keyboard_modifier_values
-		for( auto modifier : _c_keyboard_modifier_values ){
+		for( auto& modifier : _c_keyboard_modifier_values ){
 			
-			if( modifier.second & bytes.at(1) ){
-				output << modifier.first;
+			if( modifier.value & bytes.at(1) ){
+				output << modifier.name;
 			}
 			
 		}
 		
-		// iterate over _c_keyboard_key_values
-		for( auto keycode : _c_keyboard_key_values ){
-			
-			if( keycode.second == bytes.at(2) ){
-				
-				output << keycode.first;
-				found_name = true;
-				break;
-				
-			}
-			
+		const auto* keycode = _c_keyboard_key_values.find_value( bytes.at(2) );
+		if( keycode != nullptr ){
+			output << keycode->name;
+			found_name = true;
 		}
 		
 	} else{ // mousebutton or special function ?
 		
-		// iterate over _c_keycodes
-		for( auto keycode : _c_keycodes ){
-			
-			if( keycode.second.at(0) == bytes.at(0) &&
-				keycode.second.at(1) == bytes.at(1) && 
-				keycode.second.at(2) == bytes.at(2) &&
-				keycode.second.at(3) == bytes.at(3) ){
-				
-				output << keycode.first;
-				found_name = true;
-				break;
-				
-			}
-			
+		const auto* keycode = _c_keycodes.find_value( bytes );
+		if( keycode != nullptr ){
+			output << keycode->name;
+			found_name = true;
 		}
 		
 	}
@@ -788,158 +1692,188 @@ int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std
 
 int rd_mouse::_i_encode_button_mapping( const std::string& mapping, std::array<uint8_t, 4>& bytes ){
 	
-	// raw byte values
-	if( std::regex_match( mapping, std::regex("0x[0-9a-fA-F]{8}") ) ){
-
-		bytes[0] = std::stoi( mapping.substr(2, 2) , 0, 16 );
-		bytes[1] = std::stoi( mapping.substr(4, 2) , 0, 16 );
-		bytes[2] = std::stoi( mapping.substr(6, 2) , 0, 16 );
-		bytes[3] = std::stoi( mapping.substr(8, 2) , 0, 16 );
-
-	// is string in _c_keycodes? mousebuttons/special functions and media controls
-	} else if( _c_keycodes.find(mapping) != _c_keycodes.end() ){
+	// parses a decimal number without sign, returns false if invalid or > max
+	auto parse_number = []( const std::string& text, size_t begin, size_t end, unsigned int max, unsigned int& value ){
+		
+		if( begin >= end || end > text.length() )
+			return false;
+		
+		value = 0;
+		for( size_t i = begin; i < end; i++ ){
+			if( text[i] < '0' || text[i] > '9' )
+				return false;
+			value = value*10 + (text[i] - '0');
+			if( value > max )
+				return false;
+		}
+		
+		return true;
+	};
+	
+	// parses a hexadecimal digit, returns -1 if invalid
+	auto hex_digit = []( char c ){
+		if( c >= '0' && c <= '9' ) return c - '0';
+		if( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+		if( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+		return -1;
+	};
+	
+	// parses "macroN" with N = 1-15 at the start of mapping, returns the position after N or 0 if invalid
+	auto parse_macro_number = []( const std::string& mapping, unsigned int& number ){
 		
-		bytes[0] = _c_keycodes[mapping][0];
-		bytes[1] = _c_keycodes[mapping][1];
-		bytes[2] = _c_keycodes[mapping][2];
-		bytes[3] = _c_keycodes[mapping][3];
+		if( mapping.compare( 0, 5, "macro" ) != 0 || mapping.length() < 6 || mapping[5] < '1' || mapping[5] > '9' )
+			return (size_t)0;
+		
+		number = mapping[5] - '0';
+		if( number == 1 && mapping.length() > 6 && mapping[6] >= '0' && mapping[6] <= '5' ){
+			number = 10 + (mapping[6] - '0');
+			return (size_t)7;
+		}
+		
+		return (size_t)6;
+	};
+	
+	// raw byte values: 0x and 8 hexadecimal digits
+	if( mapping.length() == 10 && mapping[0] == '0' && mapping[1] == 'x' ){
+		
+		std::array<uint8_t, 4> raw;
+		for( size_t i = 0; i < 4; i++ ){
+			int high = hex_digit( mapping[2+2*i] ), low = hex_digit( mapping[3+2*i] );
+			if( high < 0 || low < 0 )
+				return 1;
+			raw[i] = (uint8_t)(high*16 + low);
+		}
+		
+		bytes = raw;
+		return 0;
+	}
+	
+	// is string in _c_keycodes? mousebuttons/special functions and media controls
+	const auto* known_mapping = _c_keycodes.find( mapping );
+	if( known_mapping != nullptr ){
+		bytes = known_mapping->value;
+		return 0;
+	}
 	
-	// fire button (multiple keypresses)
-	} else if( mapping.find("fire") == 0 ){
+	// fire button (multiple keypresses): fire:button:repeats:delay
+	if( mapping.compare( 0, 4, "fire" ) == 0 ){
 		
-		std::stringstream mapping_stream(mapping);
-		std::string value1 = "", value2 = "", value3 = "";
-		uint8_t keycode, repeats = 1, delay = 0;
+		// fields between the colons, the first one is skipped
+		size_t colon1 = mapping.find( ':' );
+		size_t colon2 = ( colon1 == std::string::npos ) ? std::string::npos : mapping.find( ':', colon1+1 );
+		size_t colon3 = ( colon2 == std::string::npos ) ? std::string::npos : mapping.find( ':', colon2+1 );
+		if( colon3 == std::string::npos )
+			return 1;
 		
-		// the repeated value1 line is not a mistake, it skips the "fire:"
-		std::getline( mapping_stream, value1, ':' );
-		std::getline( mapping_stream, value1, ':' );
-		std::getline( mapping_stream, value2, ':' );
-		std::getline( mapping_stream, value3, ':' );
+		size_t end = std::min( mapping.find( ':', colon3+1 ), mapping.length() );
+		std::string button = mapping.substr( colon1+1, colon2-colon1-1 );
+		uint8_t keycode;
+		unsigned int repeats, delay;
 		
-		if( value1 == "mouse_left" ){
+		if( button == "mouse_left" ){
 			keycode = 0x81;
-		} else if( value1 == "mouse_right" ){
+		} else if( button == "mouse_right" ){
 			keycode = 0x82;
-		} else if( value1 == "mouse_middle" ){
+		} else if( button == "mouse_middle" ){
 			keycode = 0x84;
-		} else if( _c_keyboard_key_values.find(value1) != _c_keyboard_key_values.end() ){
-			keycode = _c_keyboard_key_values[value1];
+		} else if( _c_keyboard_key_values.contains(button) ){
+			keycode = _c_keyboard_key_values.find(button)->value;
 		} else{
 			return 1;
 		}
 		
-		repeats = (uint8_t)stoi(value2);
-		delay = (uint8_t)stoi(value3);
+		if( !parse_number( mapping, colon2+1, colon3, 255, repeats ) || !parse_number( mapping, colon3+1, end, 255, delay ) )
+			return 1;
 		
 		// store values
 		bytes[0] = 0x99;
 		bytes[1] = keycode;
 		bytes[2] = repeats;
 		bytes[3] = delay;
+		return 0;
+	}
 	
-	// snipe button (changes dpi while pressed)
-	} else if( mapping.find("snipe") == 0 ){
+	// snipe button (changes dpi while pressed): snipe:dpi
+	if( mapping.compare( 0, 5, "snipe" ) == 0 ){
 		
-		try{
-			
-			int dpi_value = std::stoi( std::regex_replace( mapping, std::regex("snipe:"), "" ) );
-			uint8_t dpi_byte = _c_snipe_dpi_values.at( dpi_value );
-			
-			bytes[0] = 0x9a;
-			bytes[1] = 0x01;
-			bytes[2] = dpi_byte;
-			bytes[3] = dpi_byte;
-			
-		} catch( std::exception& f ){ // invalid mapping pattern or dpi
+		unsigned int dpi_value;
+		if( mapping.compare( 0, 6, "snipe:" ) != 0 || !parse_number( mapping, 6, mapping.length(), 100000, dpi_value ) )
 			return 1;
-		}
-	
-	// macro (no repeats)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5])") ) ){
 		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("macro"), "" ) ) - 1;
-			bytes[2] = 0x01;
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
+		auto dpi_byte = std::find_if( _c_snipe_dpi_values.begin(), _c_snipe_dpi_values.end(),
+			[dpi_value]( auto& dpi ){ return dpi.first == (int)dpi_value; } );
+		if( dpi_byte == _c_snipe_dpi_values.end() )
 			return 1;
-		}
-	
-	// macro (repeats)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):\\d+") ) ){
 		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:\\d+)"), "" ) ) - 1;
-			bytes[2] = std::stoi( std::regex_replace( mapping, std::regex("macro\\d+:"), "" ) );
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
+		bytes[0] = 0x9a;
+		bytes[1] = 0x01;
+		bytes[2] = dpi_byte->second;
+		bytes[3] = dpi_byte->second;
+		return 0;
+	}
 	
-	// macro (repeat until button is pressed again)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):until") ) ){
+	// macro: macroN, macroN:repeats, macroN:until, macroN:while
+	unsigned int macro_number;
+	size_t macro_end = parse_macro_number( mapping, macro_number );
+	if( macro_end != 0 ){
 		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:until)"), "" ) ) + 0x3f;
-			bytes[2] = 0xff;
-			bytes[3] = 0xff;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	
-	// macro (repeat while button id held down)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):while") ) ){
+		unsigned int repeats;
 		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:while)"), "" ) ) + 0x7f;
-			bytes[2] = 0xff;
-			bytes[3] = 0xff;
-			
-		} catch( std::exception& f ){
-			return 1;
+		if( macro_end == mapping.length() ){ // no repeats
+			bytes = { 0x91, (uint8_t)(macro_number - 1), 0x01, 0x00 };
+			return 0;
+		} else if( mapping[macro_end] != ':' ){
+			// not a macro, e.g. "macro16"
+		} else if( mapping.compare( macro_end+1, std::string::npos, "until" ) == 0 ){ // repeat until button is pressed again
+			bytes = { 0x91, (uint8_t)(macro_number + 0x3f), 0xff, 0xff };
+			return 0;
+		} else if( mapping.compare( macro_end+1, std::string::npos, "while" ) == 0 ){ // repeat while button id held down
+			bytes = { 0x91, (uint8_t)(macro_number + 0x7f), 0xff, 0xff };
+			return 0;
+		} else if( parse_number( mapping, macro_end+1, mapping.length(), 255, repeats ) ){ // repeats
+			bytes = { 0x91, (uint8_t)(macro_number - 1), (uint8_t)repeats, 0x00 };
+			return 0;
 		}
+	}
 	
-	// string is not a key in _c_keycodes: keyboard key (+ modifiers) ?
-	} else{
-		
-		// search for modifiers and change values accordingly: ctrl, shift ...
-		uint8_t first_value = 0x90;
-		uint8_t modifier_value = 0x00;
-		for( auto i : _c_keyboard_modifier_values ){
-			if( mapping.find( i.first ) != std::string::npos ){
-				modifier_value += i.second;
-				first_value = 0x8f;
-			}
+	// keyboard key (+ modifiers), e.g. ctrl_l+shift_l+a
+	
+	// search for modifiers and change values accordingly: ctrl, shift ...
+	uint8_t first_value = 0x90;
+	uint8_t modifier_value = 0x00;
+	for( auto& modifier : _c_keyboard_modifier_values ){
+		if( mapping.find( modifier.name ) != std::string::npos ){
+			modifier_value += modifier.value;
+			first_value = 0x8f;
 		}
-		
-		// get key value and store everything
-		try{
-			
-			std::regex modifier_regex ("[a-z_]*\\+");
-			
-			// store values
-			bytes[0] = first_value;
-			bytes[1] = modifier_value;
-			bytes[2] = _c_keyboard_key_values[std::regex_replace( mapping, modifier_regex, "" )];
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
-			return 1;
+	}
+	
+	// the key is what remains after removing every '+' and the lowercase name ([a-z_]) in front of it
+	std::string key;
+	size_t segment = 0;
+	for( size_t i = 0; i <= mapping.length(); i++ ){
+		
+		if( i == mapping.length() ){
+			key.append( mapping, segment, i-segment );
+		} else if( mapping[i] == '+' ){
+			size_t name = i;
+			while( name > segment && ( (mapping[name-1] >= 'a' && mapping[name-1] <= 'z') || mapping[name-1] == '_' ) )
+				name--;
+			key.append( mapping, segment, name-segment );
+			segment = i+1;
 		}
 	}
 	
+	const auto* key_value = _c_keyboard_key_values.find( key );
+	if( key_value == nullptr )
+		return 1;
+	
+	// store values
+	bytes[0] = first_value;
+	bytes[1] = modifier_value;
+	bytes[2] = key_value->value;
+	bytes[3] = 0x00;
+	
 	return 0;
 }
 
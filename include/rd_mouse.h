@@ -24,8 +24,10 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -37,6 +39,11 @@
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include "rd_lookup_table.h"
+#include "rd_model_registry.h"
+#include "transport.h"
 
 /* These declarations exist to make it possible for mouse_variant
  * to use these classes.
@@ -54,17 +61,6 @@ class mouse_m913;
 class mouse_m990;
 class mouse_m990chroma;
 
-/// Calls the function fn with an object of each type in the variant V
-template< typename V, size_t I = std::variant_size_v<V>-1, typename F > void variant_loop(F fn){
-
-	V var = V(std::in_place_index<I>);
-	std::visit( fn, var );
-
-	if constexpr ( I > 0 ){
-		variant_loop< V, I-1, F >(fn);
-	}
-}
-
 /**
  * This class is used as a base for the different models
  * 
@@ -89,6 +85,7 @@ class rd_mouse{
 				(void)pid;
 				return false;
 			}
+			static constexpr std::array< rd_usb_id, 0 > usb_ids(){ return {}; }
 		};
 
 		// enums
@@ -141,6 +138,9 @@ class rd_mouse{
 			mouse_generic // needs to be last to take the lowest priority during detection
 		> mouse_variant;
 		
+		/// The USB ids of all mice, the order of mouse_variant is the priority during detection
+		typedef rd_model_registry< mouse_variant > model_registry;
+		
 		/** \brief Detects supported mice
 		 * In the case of multiple connected mice, only the first will be detected
 		 * \return A mouse_variant containing an object corresponding to the detected mouse, or rd_mouse::monostate
@@ -154,6 +154,34 @@ class rd_mouse{
 		 */
 		static mouse_variant detect( const std::string& mouse_name );
 		
+		/// A detected mouse and its position on the USB bus, see detect_all()
+		struct rd_device;
+		
+		/** \brief Detects all supported mice
+		 * \arg mouse_name only detect mice with name = mouse_name, all mice if empty
+		 * \return A rd_device for each detected mouse
+		 */
+		static std::vector< rd_device > detect_all( const std::string& mouse_name = "" );
+		
+		/** \brief Creates an object for the mouse with the specified name, without accessing the USB devices
+		 * \return A mouse_variant containing the object, or rd_mouse::monostate if the name is unknown
+		 */
+		static mouse_variant create( const std::string& mouse_name );
+		
+		/** \brief Called by watch() for each mouse that has been connected
+		 * \arg device the mouse, not opened
+		 * \arg arrival time when libusb reported the mouse
+		 */
+		typedef std::function< void( const rd_device& device, std::chrono::steady_clock::time_point arrival ) > arrival_handler;
+		
+		/** \brief Waits for supported mice to be connected using libusb hotplug events and calls handler for each of them
+		 * Mice connected before calling this function are reported as well.
+		 * Returns after SIGINT or SIGTERM has been received.
+		 * \arg mouse_name only report mice with name = mouse_name, all mice if empty
+		 * \return 0 if successful, 1 if hotplug events are not supported
+		 */
+		static int watch( const std::string& mouse_name, arrival_handler handler );
+		
 		/// Set whether to try to detach the kernel driver when opening the mouse
 		void set_detach_kernel_driver( bool detach_kernel_driver ){
 			_i_detach_kernel_driver = detach_kernel_driver;
@@ -161,6 +189,205 @@ class rd_mouse{
 		/// Get _i_detach_kernel_driver
 		bool get_detach_kernel_driver(){ return _i_detach_kernel_driver; }
 		
+		/** \brief Set whether write_settings() reads the settings from the mouse first and only sends the changed packets
+		 * This is only supported by some models, the others always send all packets.
+		 */
+		void set_differential_write( bool differential_write ){
+			_i_differential_write = differential_write;
+			_i_skipped_packets = -1;
+		}
+		/// Get the number of packets skipped by the last differential write, -1 if no differential write was performed
+		int get_skipped_packets(){ return _i_skipped_packets; }
+		
+		/** \brief Set whether write_settings() and write_macro() read back the written memory and re-send mismatching packets
+		 * This is only supported by some models, see _i_write_verified().
+		 */
+		void set_verify( bool verify ){
+			_i_verify = verify;
+			_i_resent_packets = -1;
+		}
+		/// Get the number of packets re-sent by the verifications since set_verify(), -1 if no verification was performed
+		int get_resent_packets(){ return _i_resent_packets; }
+		
+		/** \brief Set the number of control transfers kept in flight by the writer functions
+		 * 1 sends one packet after another with blocking transfers (default),
+		 * larger values submit the packets asynchronously, in order.
+		 */
+		void set_transfer_window( unsigned int transfer_window ){
+			_i_transfer_window = (transfer_window == 0) ? 1 : transfer_window;
+		}
+		/// Get _i_transfer_window
+		unsigned int get_transfer_window(){ return _i_transfer_window; }
+		
+		/// Set the timeout of each USB transfer in milliseconds (default 1000)
+		void set_transfer_timeout( unsigned int transfer_timeout ){
+			_i_transfer_timeout = (transfer_timeout == 0) ? 1 : transfer_timeout;
+		}
+		/// Get _i_transfer_timeout
+		unsigned int get_transfer_timeout(){ return _i_transfer_timeout; }
+		
+		/** \brief Set the time limit of an operation in milliseconds, see begin_operation()
+		 * 0 disables the limit (default).
+		 */
+		void set_operation_timeout( unsigned int operation_timeout ){ _i_operation_timeout = operation_timeout; }
+		/// Get _i_operation_timeout
+		unsigned int get_operation_timeout(){ return _i_operation_timeout; }
+		
+		/** \brief Start an operation (e.g. write_settings()), resets the transfer error
+		 * Transfers after the time limit of the operation has passed fail with LIBUSB_ERROR_TIMEOUT.
+		 * After LIBUSB_ERROR_NO_DEVICE all transfers fail immediately, also in later operations.
+		 */
+		void begin_operation();
+		
+		/// libusb error code of the first failed transfer of the current operation, 0 if none failed
+		int get_transfer_error(){ return _i_transfer_error; }
+		
+		/** \brief Set the transport that performs the transfers instead of libusb, nullptr restores libusb
+		 * The transport has to stay valid while it is set. If the transport does not use the device
+		 * (e.g. rd_replay_transport), open_mouse() and close_mouse() do not access libusb.
+		 * The transfer window is only used if the transport supports asynchronous transfers.
+		 */
+		void set_transport( rd_transport* transport ){ _i_transport = transport; }
+		/// Get the transport set with set_transport(), nullptr if libusb is used
+		rd_transport* get_transport(){ return _i_transport; }
+		
+		/** \brief Get the USB vendor and product id of the opened mouse
+		 * \return 0 if successful
+		 */
+		int get_vid_pid( uint16_t& vid, uint16_t& pid );
+		
+		/// A control transfer sent by the writer functions, see _i_write_packets()
+		struct rd_packet{
+			uint8_t request_type;
+			uint8_t request;
+			uint16_t value;
+			uint16_t index;
+			std::vector< uint8_t > data;
+			/// whether a write request (0xf3) is read back by set_verify(), false for memory that can not be read
+			bool verify = true;
+			
+			/// Defaults to a HID set report request to interface 2, as used by most packets, data may be nullptr if length is 0
+			rd_packet( uint16_t value, const uint8_t* data, size_t length, uint8_t request_type = 0x21, uint8_t request = 0x09 ) :
+				request_type(request_type), request(request), value(value), index(0x0002){
+				if( data != nullptr && length > 0 )
+					this->data.assign( data, data+length );
+			}
+		};
+		
+		/** \brief Set a vector that receives the packets of the writer functions instead of the mouse
+		 * This allows preparing all packets without an opened mouse, nullptr disables capturing.
+		 * Only supported by the wired mice.
+		 */
+		void set_packet_capture( std::vector< rd_packet >* packets ){ _i_packet_capture = packets; }
+		
+		/**
+		 * The settings changed by the setters since they were last written by write_changes()
+		 * of the model classes. A new object has no changes, the settings written by the first
+		 * write_changes() are the ones changed by the setters.
+		 */
+		struct rd_changes{
+			/// the active profile (set_profile())
+			bool profile = false;
+			/// the settings of each profile
+			std::array< bool, 5 > profiles = {};
+			/// each macro slot
+			std::array< bool, 15 > macros = {};
+			
+			/// whether any settings of a profile changed
+			bool any_profile() const{ return std::find( profiles.begin(), profiles.end(), true ) != profiles.end(); }
+		};
+		
+		/// Get the changes that have not been written by write_changes()
+		const rd_changes& get_changes(){ return _i_changes; }
+		
+		/** \brief Send packets prepared with set_packet_capture() to the mouse
+		 * \return 0 if all packets were sent successfully, otherwise the number of failed or unsent packets
+		 */
+		int write_packets( const std::vector< rd_packet >& packets ){ return _i_write_packets( packets ); }
+		
+		/**
+		 * The sections of the settings read by read_snapshot() of the model classes, only the
+		 * responses needed for the selected sections are requested from the mouse.
+		 * By default everything is selected.
+		 */
+		struct rd_read_selection{
+			/// number of the active profile
+			bool active_profile;
+			/// battery level (wireless mice)
+			bool battery;
+			/// per profile: LED settings, report rate, DPI levels and button mapping
+			std::array< bool, 5 > led, report_rate, dpi, buttons;
+			/// per macro slot
+			std::array< bool, 15 > macros;
+			
+			rd_read_selection(){ set_all( true ); }
+			
+			/// Select or deselect every section
+			void set_all( bool selected ){
+				active_profile = battery = selected;
+				led.fill( selected );
+				report_rate.fill( selected );
+				dpi.fill( selected );
+				buttons.fill( selected );
+				macros.fill( selected );
+			}
+			
+			/// Whether every section is selected
+			bool everything() const{
+				auto all = []( const auto& sections ){ return std::find( sections.begin(), sections.end(), false ) == sections.end(); };
+				return active_profile && battery && all( led ) && all( report_rate ) && all( dpi ) && all( buttons ) && all( macros );
+			}
+			
+			/// Whether any section of a profile (0-4) is selected
+			bool profile( int profile ) const{
+				return led[profile] || report_rate[profile] || dpi[profile] || buttons[profile];
+			}
+			
+			/// Whether any macro is selected
+			bool any_macro() const{
+				return std::find( macros.begin(), macros.end(), true ) != macros.end();
+			}
+			
+			/** \brief Select the sections of a comma separated list, e.g. "profile2.dpi,macros:3"
+			 * Sections: profile (active profile), battery, led, report_rate, dpi, buttons (of all profiles),
+			 * profile⟨1-5⟩ (all sections of a profile), profile⟨1-5⟩.⟨section⟩, macros, macros:⟨1-15⟩
+			 * \return 0 if successful, 1 if the list is invalid
+			 */
+			int parse( const std::string& sections );
+		};
+		
+		/**
+		 * The responses of the mouse to the read sequence of the reader functions, see read_snapshot()
+		 * of the model classes. The layout of the parts depends on the model.
+		 */
+		struct rd_device_snapshot{
+			/// the sections that were read, responses that were not needed are not requested (length 0)
+			rd_read_selection selection;
+			/// requested[p][i] is false if response i of part p was not requested, empty if all were requested
+			std::vector< std::vector< bool > > requested;
+			/// parts[p][i] is the i-th response of part p, padded with 0x00 if the response was shorter
+			std::vector< std::vector< std::vector< uint8_t > > > parts;
+			/// lengths[p][i] is the number of bytes received for parts[p][i], negative for libusb errors
+			std::vector< std::vector< int > > lengths;
+			
+			/// Append a part with the specified number of responses of length bytes each
+			void add_part( size_t responses, size_t length ){
+				parts.emplace_back( responses, std::vector< uint8_t >( length, 0x00 ) );
+				lengths.emplace_back( responses, 0 );
+			}
+			
+			/// Whether data was received for every requested response
+			bool complete() const{
+				for( size_t p = 0; p < lengths.size(); p++ ){
+					for( size_t i = 0; i < lengths[p].size(); i++ ){
+						if( lengths[p][i] <= 0 && ( requested.empty() || requested[p][i] ) )
+							return false;
+					}
+				}
+				return true;
+			}
+		};
+		
 		/// Returns a reference to _c_lightmode_strings (lighmode names)
 		std::map< rd_mouse::rd_lightmode, std::string >& lightmode_strings(){ return _c_lightmode_strings; }
 		/// Returns a reference to _c_report_rate_strings (report rate names)
@@ -178,13 +405,13 @@ class rd_mouse{
 		
 		//mapping of button names to values
 		/// Values/keycodes of mouse buttons and special button functions
-		static std::map< std::string, std::array<uint8_t, 4> > _c_keycodes;
+		static const rd_lookup_table< std::array<uint8_t, 4> > _c_keycodes;
 		/// Values of keyboard modifiers
-		static const std::map< std::string, uint8_t > _c_keyboard_modifier_values;
+		static const rd_lookup_table< uint8_t > _c_keyboard_modifier_values;
 		/// Values/keycodes of keyboard keys
-		static std::map< std::string, uint8_t > _c_keyboard_key_values;
-		/// DPI values for the snipe button
-		static std::map< int, uint8_t > _c_snipe_dpi_values;
+		static const rd_lookup_table< uint8_t > _c_keyboard_key_values;
+		/// DPI values for the snipe button, sorted by DPI
+		static const std::array< std::pair< int, uint8_t >, 10 > _c_snipe_dpi_values;
 		/// Bytecode for the poll/report rate
 		static std::map< uint8_t, rd_mouse::rd_report_rate > _c_report_rate_values;
 		/// String representations for the poll/report rate
@@ -197,6 +424,10 @@ class rd_mouse{
 		//usb device handling
 		/// libusb device handle
 		libusb_device_handle* _i_handle = nullptr;
+		/// transport set with set_transport(), nullptr = _i_libusb_transport
+		rd_transport* _i_transport = nullptr;
+		/// transfers with libusb to _i_handle
+		rd_libusb_transport _i_libusb_transport;
 		/// whether to detach kernel driver
 		bool _i_detach_kernel_driver = true;
 		/// set by open_mouse for close_mouse
@@ -206,6 +437,53 @@ class rd_mouse{
 		/// set by open_mouse for close_mouse
 		bool _i_detached_driver_2 = false;
 		
+		//differential write
+		/// whether write_settings() only sends changed packets
+		bool _i_differential_write = false;
+		/// number of packets skipped by the last differential write, -1 if none was performed
+		int _i_skipped_packets = -1;
+		
+		//verification
+		/// whether write_settings() and write_macro() read back the written memory
+		bool _i_verify = false;
+		/// number of packets re-sent by the verifications since set_verify(), -1 if none was performed
+		int _i_resent_packets = -1;
+		/// rounds of readback and re-sending before a mismatch is reported
+		static const int _c_verify_attempts = 2;
+		/// maximum number of bytes of a read request, as used by the read sequence of the wired mice
+		static const size_t _c_verify_read_length = 32;
+		
+		//changes
+		/// settings changed since the last write_changes()
+		rd_changes _i_changes;
+		/// packets of the settings and of each macro slot sent by the last write_changes(), empty if unknown
+		std::vector< rd_packet > _i_written_settings;
+		std::array< std::vector< rd_packet >, 15 > _i_written_macros;
+		/// set during write_changes(), other writes make the written packets unknown
+		bool _i_writing_changes = false;
+		
+		//profile switch
+		/// packets of write_profile() for each profile, prepared by the first call
+		std::array< std::vector< rd_packet >, 5 > _i_profile_packets;
+		
+		//transfer engine
+		/// number of control transfers in flight, 1 = blocking transfers
+		unsigned int _i_transfer_window = 1;
+		/// if not nullptr, _i_write_packets() appends the packets to this vector instead of sending them
+		std::vector< rd_packet >* _i_packet_capture = nullptr;
+		/// timeout of each transfer in milliseconds
+		unsigned int _i_transfer_timeout = 1000;
+		/// time limit of an operation in milliseconds, 0 = no limit
+		unsigned int _i_operation_timeout = 0;
+		/// end of the current operation, only used if _i_operation_timeout > 0
+		std::chrono::steady_clock::time_point _i_operation_deadline;
+		/// first libusb error of the current operation, LIBUSB_ERROR_NO_DEVICE is kept
+		int _i_transfer_error = 0;
+		/// attempts of a transfer that failed with LIBUSB_ERROR_BUSY or LIBUSB_ERROR_PIPE
+		static const unsigned int _c_transfer_attempts = 4;
+		/// delay before the first retry in milliseconds, doubled for each retry
+		static const unsigned int _c_retry_delay = 2;
+		
 		/** \brief Init libusb and open the mouse by its USB VID and PID
 		 * \return 0 if successful
 		 */
@@ -221,6 +499,130 @@ class rd_mouse{
 		 */
 		int _i_close_mouse();
 		
+		/** \brief Finds the mouse with the given vid and pid
+		 * \arg mouse_name only match mice with name = mouse_name, all mice if empty
+		 * \return A mouse_variant with vid and pid set, or rd_mouse::monostate
+		 */
+		static mouse_variant _i_match( uint16_t vid, uint16_t pid, const std::string& mouse_name );
+		
+		/// Fills device (except the mouse) with the bus, device address and the bus/port path of usb_device
+		static void _i_locate( libusb_device* usb_device, rd_device& device );
+		
+		/** \brief Send read requests (0xf2) and store the received data in memory (address → byte)
+		 * Rows that are not read requests are sent without reading a response.
+		 * Only data from complete responses is stored, unknown addresses are missing in memory.
+		 * \arg rows the packets, row_count * row_length bytes
+		 * \arg value wValue of the control transfers, e.g. 0x0302
+		 * \return 0 if successful
+		 */
+		int _i_read_memory( const uint8_t* rows, size_t row_count, size_t row_length, uint16_t value, std::map< uint16_t, uint8_t >& memory );
+		
+		/// Same as above for rows with different lengths and wValues
+		int _i_read_memory( const std::vector< rd_packet >& rows, std::map< uint16_t, uint8_t >& memory );
+		
+		/** \brief Read the memory written by the write requests (0xf3) in packets, other packets are ignored
+		 * The written ranges are merged into as few read requests (0xf2) of up to _c_verify_read_length
+		 * bytes as possible, framed like the read sequence of the wired mice, see _i_read_memory().
+		 * \return 0 if successful
+		 */
+		int _i_read_written( const std::vector< const rd_packet* >& packets, std::map< uint16_t, uint8_t >& memory );
+		
+		/** \brief Check whether a packet is a write request (0xf3) that would not change memory
+		 * \return true if all written addresses are known and hold the same values
+		 */
+		static bool _i_write_unchanged( const uint8_t* packet, size_t packet_length, const std::map< uint16_t, uint8_t >& memory );
+		
+		/** \brief Perform a transfer with the timeouts and the retries of the current operation
+		 * All transfers to the mouse go through this function, see begin_operation().
+		 * \arg transfer performs the transfer with the given timeout in milliseconds and returns
+		 * the number of transferred bytes or a libusb error code
+		 * \return the return value of transfer, or a libusb error code if the transfer was not attempted
+		 */
+		int _i_transfer( const std::function< int( unsigned int ) >& transfer );
+		
+		/// Control transfer to the opened mouse through _i_transfer()
+		int _i_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length );
+		
+		/// Interrupt transfer to the opened mouse through _i_transfer(), returns the number of transferred bytes
+		int _i_interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred );
+		
+		/// The transport of the transfers, _i_transport if set, otherwise _i_libusb_transport
+		rd_transport& _i_get_transport(){ return (_i_transport != nullptr) ? *_i_transport : _i_libusb_transport; }
+		
+		/** \brief Whether the mouse is simulated by the transport (see rd_transport::uses_device())
+		 * Used by the open and close functions of the models to skip libusb.
+		 */
+		bool _i_simulated(){ return !_i_get_transport().uses_device(); }
+		
+		/// Pass _i_handle to the transport after opening the mouse, see rd_transport::set_handle()
+		void _i_attach_transport(){ _i_get_transport().set_handle( _i_handle ); }
+		
+		/** \brief Remaining time of the current operation in milliseconds, capped at _i_transfer_timeout
+		 * \return 0 if the time limit has passed
+		 */
+		unsigned int _i_remaining_time();
+		
+		/** \brief Send a sequence of packets in order, keeping up to _i_transfer_window transfers in flight
+		 * Returns after all submitted transfers have completed. If a transfer can not be submitted,
+		 * the mouse is gone or the time limit of the operation has passed, the remaining packets are not sent.
+		 * \return 0 if all packets were sent successfully, otherwise the number of failed or unsent packets
+		 */
+		int _i_write_packets( const std::vector< rd_packet >& packets );
+		
+		/** \brief Send packets with _i_write_packets() and verify the write requests (0xf3) if set_verify() is enabled
+		 * Only the written memory is read back with _i_read_written(). Packets whose memory differs from the
+		 * written data are re-sent, this is repeated up to _c_verify_attempts times.
+		 * \return 0 if successful, otherwise the number of failed, unsent or still mismatching packets
+		 */
+		int _i_write_verified( const std::vector< rd_packet >& packets );
+		
+		
+		/** \brief Write the settings, macros and active profile changed since the last call, used by write_changes()
+		 * Only the sections marked in _i_changes are written. If rows is true, the packets of a section
+		 * are compared with the packets written last time and only the changed rows are sent, see
+		 * _i_write_changed_rows(). Otherwise, for protocols where the packets depend on each other,
+		 * the writer functions are called for each changed section. With a differential write
+		 * (see set_differential_write()) the settings are always compared with the memory of the mouse.
+		 * \arg settings, macro, profile the write_settings(), write_macro() and write_profile() functions of the model
+		 * \return 0 if successful, otherwise the sum of the return values of the writers
+		 */
+		int _i_write_changes( const std::function< int() >& settings, const std::function< int( int ) >& macro,
+			const std::function< int() >& profile, bool rows );
+		
+		/** \brief Send the rows of a section that differ from the packets written last time
+		 * The packets are prepared by calling writer with packet capturing (see set_packet_capture()). All packets
+		 * are sent by writer if nothing was written before, if the number of packets changed or if a changed packet
+		 * is not a write request (0xf3). Otherwise the unchanged write requests are left out and the remaining
+		 * packets are sent in their original order, the same rule as a differential write (see set_differential_write()).
+		 * \arg written the packets written last time, replaced by the new packets if successful
+		 * \arg skipped if not nullptr, receives the number of unchanged write requests
+		 * \return 0 if successful
+		 */
+		int _i_write_changed_rows( const std::function< int() >& writer, std::vector< rd_packet >& written, int* skipped );
+		
+		/** \brief Send some rows of the settings outside of write_settings(), used by write_dpi()
+		 * The packets are sent with _i_write_verified(). The rows also replace the rows with the same
+		 * address in the packets written by write_changes(), so these stay comparable.
+		 * \return 0 if successful, see _i_write_verified()
+		 */
+		int _i_write_settings_rows( const std::vector< rd_packet >& packets );
+		
+		/** \brief Print a snapshot as hexdump, one "Part N:" section per part, used by the wired mice
+		 * Only the received bytes of each response are printed.
+		 */
+		static void _i_dump_snapshot( const rd_device_snapshot& snapshot, std::ostream& output );
+		
+		/** \brief The responses of the wired read sequence that are needed for a selection
+		 * The layout is shared by the wired models: part 1 holds the active profile, the LED settings
+		 * and the report rates, part 2 the DPI levels and the macros, part 3 the button mappings.
+		 * \arg responses1, responses2, responses3 number of responses of each part
+		 * \arg buttons number of button mapping responses per profile in part 3
+		 * \return mask[p][i] is true if response i of part p is needed
+		 */
+		static std::array< std::vector< bool >, 3 > _i_wired_read_mask( const rd_read_selection& selection,
+			size_t responses1, size_t responses2, size_t responses3, size_t buttons );
+		
 		
 		// bytecode/string conversion functions TODO! add missing functions
 		/** \brief Decode macro byte code (of one macro) and print the commands to output
@@ -232,6 +634,23 @@ class rd_mouse{
 		 */
 		static int _i_decode_macro( const std::vector< uint8_t >& macro_bytes, std::ostream& output, const std::string& prefix, size_t offset );
 		
+		/** \brief Decode macro byte code (of one macro) and append the commands to output
+		 * The codes are decoded with a dispatch table indexed by their first byte, all reads are bounds-checked.
+		 * \arg macro_bytes the macro bytecode, size bytes long
+		 * \arg output where to append to
+		 * \arg prefix string printed before each action
+		 * \return 0 if no invalid codes were encountered
+		 */
+		static int _i_decode_macro( const uint8_t* macro_bytes, size_t size, std::string& output, const std::string& prefix );
+		
+		/** \brief Decode all defined macros of a macro bank and print them as comments, for the dump functions
+		 * \arg macro_data the macros, as stored by the model classes
+		 * \arg output where to print to
+		 * \arg offset the macro bytecode starts at macro_data[i][offset]
+		 * \return 0 if no invalid codes were encountered
+		 */
+		static int _i_decode_macros( const std::array< std::array< uint8_t, 256 >, 15 >& macro_data, std::ostream& output, size_t offset );
+		
 		/** \brief Encode macro commands to macro bytecode
 		 * \arg macro_bytes holds the result
 		 * \arg input where the macro commands are read from
@@ -298,3 +717,20 @@ class rd_mouse{
 #include "m990/mouse_m990.h"
 #include "m990chroma/mouse_m990chroma.h"
 #include "generic/mouse_generic.h"
+
+#ifndef RD_MOUSE_DEVICE
+#define RD_MOUSE_DEVICE
+
+/// This is defined after the models, because mouse_variant requires the complete types
+struct rd_mouse::rd_device{
+	/// the mouse object, not opened
+	mouse_variant mouse;
+	/// USB bus id, for open_mouse_bus_device()
+	uint8_t bus;
+	/// USB device address, for open_mouse_bus_device()
+	uint8_t device;
+	/// bus and port numbers, e.g. 1-3.2, stays the same while the mouse is connected to the same port
+	std::string path;
+};
+
+#endif
@@ -18,8 +18,10 @@
 
 #include "rd_mouse_wireless.h"
 #include <cstdint>
+#include <iterator>
 
-std::map< std::string, std::array<uint8_t, 4> > rd_mouse_wireless::_c_keycodes = {
+// sorted and indexed at compile time, see rd_lookup_table.h
+static constexpr rd_named_value< std::array<uint8_t, 4> > keycodes[] = {
 	{ "left", { 0x01, 0x01, 0x00, 0x53 } },
 	{ "right", { 0x01, 0x02, 0x00, 0x52 } },
 	{ "middle", { 0x01, 0x04, 0x00, 0x50 } },
@@ -35,6 +37,9 @@ std::map< std::string, std::array<uint8_t, 4> > rd_mouse_wireless::_c_keycodes =
 	{ "profile_switch", { 0x09, 0x00, 0x00, 0x4c } },
 	{ "fire", { 0x04, 0x14, 0x03, 0x3a } },
 };
+static constexpr rd_lookup_table_data< std::array<uint8_t, 4>, std::size(keycodes) > keycodes_data( keycodes );
+static_assert( keycodes_data.unique_names(), "duplicate name" );
+const rd_lookup_table< std::array<uint8_t, 4> > rd_mouse_wireless::_c_keycodes = keycodes_data.table();
 
 uint8_t rd_mouse_wireless::_i_keyboard_key_checksum(uint8_t scancode){
 	return (uint8_t)(0x91 - (uint8_t)(2 * scancode));
@@ -25,6 +25,8 @@
 #include <vector>
 #include <cstdint>
 
+#include "rd_lookup_table.h"
+
 /**
  * This class holds data that is shared between the wireless mice.
  */
@@ -33,7 +35,7 @@ class rd_mouse_wireless{
 	protected:
 		
 		/// Values/keycodes of mouse buttons and special button functions
-		static std::map< std::string, std::array<uint8_t, 4> > _c_keycodes;
+		static const rd_lookup_table< std::array<uint8_t, 4> > _c_keycodes;
 
 		/// Computes the checksum used when mapping a button as a keyboard key
 		static uint8_t _i_keyboard_key_checksum(uint8_t scancode);
@@ -0,0 +1,186 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "snapshot_file.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void rd_snapshot_file::_i_append( std::string& data, uint32_t value, size_t bytes ){
+	for( size_t i = 0; i < bytes; i++ )
+		data.push_back( (char)((value >> (8*i)) & 0xff) );
+}
+
+int rd_snapshot_file::write( const std::string& path, const std::string& model, uint16_t vid, uint16_t pid,
+	const rd_mouse::rd_device_snapshot& snapshot ){
+
+	if( model.size() >= _c_model_length || snapshot.lengths.size() != snapshot.parts.size() )
+		return 1;
+
+	// header
+	std::string file( "RDSNAPSH" );
+	_i_append( file, version, 4 );
+	_i_append( file, snapshot.parts.size(), 4 );
+	_i_append( file, vid, 2 );
+	_i_append( file, pid, 2 );
+	_i_append( file, 0, 4 );
+	file += model;
+	file.append( _c_model_length - model.size(), '\0' );
+
+	// parts, all responses of a part have the same length
+	for( size_t i = 0; i < snapshot.parts.size(); i++ ){
+
+		const auto& part = snapshot.parts[i];
+		size_t length = part.empty() ? 0 : part[0].size();
+
+		if( snapshot.lengths[i].size() != part.size() )
+			return 1;
+
+		_i_append( file, part.size(), 4 );
+		_i_append( file, length, 4 );
+
+		for( size_t j = 0; j < part.size(); j++ ){
+
+			if( part[j].size() != length )
+				return 1;
+
+			_i_append( file, (uint32_t)snapshot.lengths[i][j], 4 );
+			file.append( part[j].begin(), part[j].end() );
+		}
+	}
+
+	std::ofstream out( path, std::ios::binary | std::ios::trunc );
+	if( !out.is_open() )
+		return 1;
+
+	out.write( file.data(), file.size() );
+	out.close();
+
+	return out.fail() ? 1 : 0;
+}
+
+int rd_snapshot_file::open( const std::string& path ){
+
+	close();
+
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return 1;
+
+	struct stat file_stat;
+	if( fstat( fd, &file_stat ) != 0 ){
+		::close( fd );
+		return 1;
+	}
+	if( file_stat.st_size < (off_t)_c_header_size ){
+		::close( fd );
+		return 2;
+	}
+
+	// the mapping stays valid after closing the file descriptor
+	void* data = mmap( nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+
+	if( data == MAP_FAILED )
+		return 1;
+
+	_i_data = (const uint8_t*)data;
+	_i_size = file_stat.st_size;
+
+	// check header
+	if( std::memcmp( _i_data, "RDSNAPSH", 8 ) != 0 || _i_read_32( _i_data+8 ) != version ||
+		_i_data[_c_header_size-1] != 0 ){
+		close();
+		return 2;
+	}
+
+	_i_part_count = _i_read_32( _i_data+12 );
+	_i_vid = _i_read_16( _i_data+16 );
+	_i_pid = _i_read_16( _i_data+18 );
+	_i_model = std::string( (const char*)_i_data+24 );
+
+	// check that all parts are complete and nothing follows them
+	size_t position = _c_header_size;
+	for( uint32_t i = 0; i < _i_part_count; i++ ){
+
+		if( _i_size - position < _c_part_header_size ){
+			close();
+			return 2;
+		}
+
+		uint64_t responses = _i_read_32( _i_data+position );
+		uint64_t length = _i_read_32( _i_data+position+4 );
+		position += _c_part_header_size;
+
+		if( (_i_size - position) / (_c_response_header_size + length) < responses ){
+			close();
+			return 2;
+		}
+
+		position += responses * (_c_response_header_size + length);
+	}
+
+	if( position != _i_size ){
+		close();
+		return 2;
+	}
+
+	return 0;
+}
+
+void rd_snapshot_file::close(){
+
+	if( _i_data != nullptr )
+		munmap( (void*)_i_data, _i_size );
+
+	_i_data = nullptr;
+	_i_size = 0;
+	_i_part_count = 0;
+	_i_vid = 0;
+	_i_pid = 0;
+	_i_model.clear();
+}
+
+void rd_snapshot_file::get_snapshot( rd_mouse::rd_device_snapshot& snapshot ){
+
+	snapshot = rd_mouse::rd_device_snapshot();
+
+	// the parts have been checked by open()
+	size_t position = _c_header_size;
+	for( uint32_t i = 0; i < _i_part_count; i++ ){
+
+		size_t responses = _i_read_32( _i_data+position );
+		size_t length = _i_read_32( _i_data+position+4 );
+		position += _c_part_header_size;
+
+		snapshot.add_part( responses, length );
+		for( size_t j = 0; j < responses; j++ ){
+
+			snapshot.lengths[i][j] = (int32_t)_i_read_32( _i_data+position );
+			position += _c_response_header_size;
+
+			std::copy( _i_data+position, _i_data+position+length, snapshot.parts[i][j].begin() );
+			position += length;
+		}
+	}
+}
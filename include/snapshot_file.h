@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_SNAPSHOT_FILE
+#define RD_SNAPSHOT_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rd_mouse.h"
+
+/**
+ * This class reads and writes snapshot files, binary copies of the raw
+ * responses of the mouse to the read sequence (see rd_mouse::rd_device_snapshot
+ * and mouse_m908 --backup and --restore).
+ *
+ * File format, all numbers little endian:
+ * - header (48 bytes): magic "RDSNAPSH", version (uint32), part count (uint32),
+ *   USB vendor id (uint16), USB product id (uint16), reserved (4 bytes, 0),
+ *   model name (24 bytes, zero padded)
+ * - for each part: response count (uint32), response length (uint32)
+ * - for each response of the part: received bytes (int32, negative for
+ *   libusb errors), data (response length bytes)
+ */
+class rd_snapshot_file{
+
+	public:
+
+		/// Version of the file format, snapshots with a different version are rejected
+		static const uint32_t version = 1;
+
+		rd_snapshot_file(){}
+		~rd_snapshot_file(){ close(); }
+		rd_snapshot_file( const rd_snapshot_file& ) = delete;
+		rd_snapshot_file& operator=( const rd_snapshot_file& ) = delete;
+
+		/** \brief Write a snapshot
+		 * \arg model name of the model the snapshot was read from
+		 * \arg vid, pid USB ids of the mouse the snapshot was read from
+		 * \return 0 if successful
+		 */
+		static int write( const std::string& path, const std::string& model, uint16_t vid, uint16_t pid,
+			const rd_mouse::rd_device_snapshot& snapshot );
+
+		/** \brief Map a snapshot and check the header and all parts
+		 * \return 0 if successful, 1 if the file could not be read, 2 if it is not a valid snapshot
+		 */
+		int open( const std::string& path );
+
+		/// Unmap the snapshot
+		void close();
+
+		/// Name of the model stored in the header
+		const std::string& get_model(){ return _i_model; }
+
+		/// USB vendor id stored in the header
+		uint16_t get_vid(){ return _i_vid; }
+
+		/// USB product id stored in the header
+		uint16_t get_pid(){ return _i_pid; }
+
+		/// Copy the responses from the mapped snapshot
+		void get_snapshot( rd_mouse::rd_device_snapshot& snapshot );
+
+	private:
+
+		/// Size of the header in bytes
+		static const size_t _c_header_size = 48;
+		/// Size of the header of a part in bytes
+		static const size_t _c_part_header_size = 8;
+		/// Size of the received bytes field of a response
+		static const size_t _c_response_header_size = 4;
+		/// Length of the model name field
+		static const size_t _c_model_length = 24;
+
+		/// The mapped file, nullptr if not open
+		const uint8_t* _i_data = nullptr;
+		/// Size of the mapped file
+		size_t _i_size = 0;
+		/// Number of parts
+		uint32_t _i_part_count = 0;
+		/// USB ids from the header
+		uint16_t _i_vid = 0, _i_pid = 0;
+		/// Model name from the header
+		std::string _i_model;
+
+		/// Read little endian numbers
+		static uint16_t _i_read_16( const uint8_t* data ){ return data[0] | (data[1] << 8); }
+		static uint32_t _i_read_32( const uint8_t* data ){ return _i_read_16( data ) | ((uint32_t)_i_read_16( data+2 ) << 16); }
+
+		/// Append little endian numbers
+		static void _i_append( std::string& data, uint32_t value, size_t bytes );
+};
+
+#endif
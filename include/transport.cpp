@@ -0,0 +1,345 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#include "transport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+int rd_libusb_transport::control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint8_t* data, uint16_t length, unsigned int timeout ){
+
+	if( _i_handle == nullptr )
+		return LIBUSB_ERROR_NO_DEVICE;
+
+	return libusb_control_transfer( _i_handle, request_type, request, value, index, data, length, timeout );
+}
+
+int rd_libusb_transport::interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ){
+
+	if( _i_handle == nullptr )
+		return LIBUSB_ERROR_NO_DEVICE;
+
+	return libusb_interrupt_transfer( _i_handle, endpoint, data, length, transferred, timeout );
+}
+
+// an asynchronous transfer of rd_libusb_transport, the buffer (setup packet + data) has to stay valid until it has completed
+struct rd_libusb_async_transfer{
+	std::vector< uint8_t > buffer;
+	rd_transport::completion_handler completed;
+	int* completed_flag;
+};
+
+void LIBUSB_CALL rd_libusb_transport::_i_transfer_callback( libusb_transfer* transfer ){
+
+	rd_libusb_async_transfer* async = static_cast< rd_libusb_async_transfer* >( transfer->user_data );
+
+	// same error codes as the synchronous transfers
+	int result = transfer->actual_length;
+	if( transfer->status == LIBUSB_TRANSFER_NO_DEVICE )
+		result = LIBUSB_ERROR_NO_DEVICE;
+	else if( transfer->status == LIBUSB_TRANSFER_TIMED_OUT )
+		result = LIBUSB_ERROR_TIMEOUT;
+	else if( transfer->status == LIBUSB_TRANSFER_STALL )
+		result = LIBUSB_ERROR_PIPE;
+	else if( transfer->status != LIBUSB_TRANSFER_COMPLETED )
+		result = LIBUSB_ERROR_IO;
+
+	async->completed( result );
+
+	// wake up wait() only after the handler has returned, this may run in the event loop of another thread
+	libusb_lock_event_waiters( NULL );
+	*async->completed_flag = 1;
+	libusb_unlock_event_waiters( NULL );
+
+	delete async;
+	libusb_free_transfer( transfer );
+}
+
+int rd_libusb_transport::submit_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	const uint8_t* data, uint16_t length, unsigned int timeout, completion_handler completed ){
+
+	if( _i_handle == nullptr )
+		return LIBUSB_ERROR_NO_DEVICE;
+
+	libusb_transfer* transfer = libusb_alloc_transfer( 0 );
+	if( transfer == NULL )
+		return LIBUSB_ERROR_NO_MEM;
+
+	rd_libusb_async_transfer* async = new rd_libusb_async_transfer{ std::vector< uint8_t >( LIBUSB_CONTROL_SETUP_SIZE + length ), completed, &_i_completed };
+
+	libusb_fill_control_setup( async->buffer.data(), request_type, request, value, index, length );
+	if( length > 0 )
+		std::copy( data, data+length, async->buffer.begin() + LIBUSB_CONTROL_SETUP_SIZE );
+
+	libusb_fill_control_transfer( transfer, _i_handle, async->buffer.data(), _i_transfer_callback, async, timeout );
+
+	int submitted = libusb_submit_transfer( transfer );
+	if( submitted != 0 ){
+		delete async;
+		libusb_free_transfer( transfer );
+	}
+
+	return submitted;
+}
+
+void rd_libusb_transport::wait(){
+
+	// the transfers time out, so this always returns
+	libusb_handle_events_completed( NULL, &_i_completed );
+
+	// reset afterwards, a transfer that completed in another thread before this call is not missed
+	libusb_lock_event_waiters( NULL );
+	_i_completed = 0;
+	libusb_unlock_event_waiters( NULL );
+}
+
+void rd_transfer_recording::_i_append( std::string& data, uint32_t value, size_t bytes ){
+	for( size_t i = 0; i < bytes; i++ )
+		data.push_back( (char)((value >> (8*i)) & 0xff) );
+}
+
+int rd_transfer_recording::write( const std::string& path ) const{
+
+	// header
+	std::string file( "RDUSBREC" );
+	_i_append( file, version, 4 );
+	_i_append( file, transfers.size(), 4 );
+
+	// transfers
+	for( auto& transfer : transfers ){
+
+		if( transfer.data.size() > 0xffff )
+			return 1;
+
+		_i_append( file, transfer.type, 1 );
+		_i_append( file, transfer.request_type, 1 );
+		_i_append( file, transfer.request, 1 );
+		_i_append( file, 0, 1 );
+		_i_append( file, transfer.value, 2 );
+		_i_append( file, transfer.index, 2 );
+		_i_append( file, transfer.data.size(), 2 );
+		_i_append( file, 0, 2 );
+		_i_append( file, (uint32_t)transfer.result, 4 );
+		_i_append( file, transfer.duration, 4 );
+		file.append( transfer.data.begin(), transfer.data.end() );
+	}
+
+	std::ofstream out( path, std::ios::binary | std::ios::trunc );
+	if( !out.is_open() )
+		return 1;
+
+	out.write( file.data(), file.size() );
+	out.close();
+
+	return out.fail() ? 1 : 0;
+}
+
+int rd_transfer_recording::read( const std::string& path ){
+
+	transfers.clear();
+
+	std::ifstream in( path, std::ios::binary );
+	if( !in.is_open() )
+		return 1;
+
+	std::string file( (std::istreambuf_iterator< char >( in )), std::istreambuf_iterator< char >() );
+	if( in.bad() )
+		return 1;
+
+	const uint8_t* data = (const uint8_t*)file.data();
+	size_t size = file.size();
+
+	// check header
+	if( size < _c_header_size || std::memcmp( data, "RDUSBREC", 8 ) != 0 || _i_read_32( data+8 ) != version )
+		return 2;
+
+	uint32_t count = _i_read_32( data+12 );
+	size_t position = _c_header_size;
+
+	for( uint32_t i = 0; i < count; i++ ){
+
+		if( size - position < _c_transfer_header_size ){
+			transfers.clear();
+			return 2;
+		}
+
+		const uint8_t* header = data + position;
+		size_t length = _i_read_16( header+8 );
+		position += _c_transfer_header_size;
+
+		if( header[0] > 1 || size - position < length ){
+			transfers.clear();
+			return 2;
+		}
+
+		rd_transfer transfer;
+		transfer.type = header[0];
+		transfer.request_type = header[1];
+		transfer.request = header[2];
+		transfer.value = _i_read_16( header+4 );
+		transfer.index = _i_read_16( header+6 );
+		transfer.result = (int32_t)_i_read_32( header+12 );
+		transfer.duration = _i_read_32( header+16 );
+		transfer.data.assign( data+position, data+position+length );
+		position += length;
+
+		transfers.push_back( std::move( transfer ) );
+	}
+
+	// nothing follows the transfers
+	if( position != size ){
+		transfers.clear();
+		return 2;
+	}
+
+	return 0;
+}
+
+int rd_record_transport::control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint8_t* data, uint16_t length, unsigned int timeout ){
+
+	rd_transfer_recording::rd_transfer transfer;
+	transfer.type = 0;
+	transfer.request_type = request_type;
+	transfer.request = request;
+	transfer.value = value;
+	transfer.index = index;
+
+	// the sent data is recorded before the transfer, the received data after it
+	if( !transfer.is_in() && data != NULL )
+		transfer.data.assign( data, data+length );
+
+	auto start = std::chrono::steady_clock::now();
+	transfer.result = _i_target.control_transfer( request_type, request, value, index, data, length, timeout );
+	transfer.duration = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - start ).count();
+
+	if( transfer.is_in() && data != NULL )
+		transfer.data.assign( data, data+length );
+
+	_i_recording.transfers.push_back( std::move( transfer ) );
+
+	return _i_recording.transfers.back().result;
+}
+
+int rd_record_transport::interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ){
+
+	rd_transfer_recording::rd_transfer transfer;
+	transfer.type = 1;
+	transfer.request_type = endpoint;
+
+	if( !transfer.is_in() && data != NULL )
+		transfer.data.assign( data, data+length );
+
+	// the number of transferred bytes is recorded as the result
+	int received = 0;
+	auto start = std::chrono::steady_clock::now();
+	int ret = _i_target.interrupt_transfer( endpoint, data, length, &received, timeout );
+	transfer.duration = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - start ).count();
+	transfer.result = ( ret < 0 ) ? ret : received;
+
+	if( transferred != NULL )
+		*transferred = received;
+
+	if( transfer.is_in() && data != NULL )
+		transfer.data.assign( data, data+length );
+
+	_i_recording.transfers.push_back( std::move( transfer ) );
+
+	return ret;
+}
+
+int rd_replay_transport::_i_replay( rd_transfer_recording::rd_transfer& transfer ){
+
+	if( _i_position >= _i_recording.transfers.size() ){
+		_i_mismatches++;
+		return LIBUSB_ERROR_IO;
+	}
+
+	const rd_transfer_recording::rd_transfer& recorded = _i_recording.transfers[_i_position];
+
+	// compare with the recording, received data can not be compared
+	if( transfer.type != recorded.type || transfer.request_type != recorded.request_type ||
+		transfer.request != recorded.request || transfer.value != recorded.value || transfer.index != recorded.index ||
+		transfer.data.size() != recorded.data.size() || ( !transfer.is_in() && transfer.data != recorded.data ) ){
+
+		_i_mismatches++;
+		return LIBUSB_ERROR_IO;
+	}
+
+	_i_position++;
+
+	unsigned int latency = _i_recorded_latency ? recorded.duration : _i_latency;
+	if( latency > 0 )
+		std::this_thread::sleep_for( std::chrono::microseconds( latency ) );
+
+	if( transfer.is_in() )
+		transfer.data = recorded.data;
+
+	return recorded.result;
+}
+
+int rd_replay_transport::control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint8_t* data, uint16_t length, unsigned int timeout ){
+
+	(void)timeout;
+
+	rd_transfer_recording::rd_transfer transfer;
+	transfer.type = 0;
+	transfer.request_type = request_type;
+	transfer.request = request;
+	transfer.value = value;
+	transfer.index = index;
+	if( data != NULL )
+		transfer.data.assign( data, data+length );
+
+	int ret = _i_replay( transfer );
+
+	if( ret >= 0 && transfer.is_in() && data != NULL )
+		std::copy( transfer.data.begin(), transfer.data.end(), data );
+
+	return ret;
+}
+
+int rd_replay_transport::interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ){
+
+	(void)timeout;
+
+	rd_transfer_recording::rd_transfer transfer;
+	transfer.type = 1;
+	transfer.request_type = endpoint;
+	if( data != NULL )
+		transfer.data.assign( data, data+length );
+
+	int ret = _i_replay( transfer );
+
+	if( transferred != NULL )
+		*transferred = ( ret < 0 ) ? 0 : ret;
+
+	if( ret < 0 )
+		return ret;
+
+	if( transfer.is_in() && data != NULL )
+		std::copy( transfer.data.begin(), transfer.data.end(), data );
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RD_TRANSPORT
+#define RD_TRANSPORT
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <libusb.h>
+
+/**
+ * This class performs the USB transfers of a mouse, see rd_mouse::set_transport().
+ *
+ * The functions have the semantics of libusb_control_transfer() and
+ * libusb_interrupt_transfer(): they return the number of transferred bytes
+ * or a libusb error code. Retries and timeouts are handled by rd_mouse.
+ *
+ * Transports that support asynchronous transfers are used by the writer
+ * functions when the transfer window is larger than 1 (see
+ * rd_mouse::set_transfer_window()), the others always get blocking transfers.
+ */
+class rd_transport{
+
+	public:
+
+		virtual ~rd_transport(){}
+
+		/// Control transfer, data is sent or received depending on bit 7 of request_type
+		virtual int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) = 0;
+
+		/// Interrupt transfer, transferred receives the number of transferred bytes
+		virtual int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) = 0;
+
+		/// Called by wait() for a completed asynchronous transfer, with the number of transferred bytes or a libusb error code
+		typedef std::function< void( int ) > completion_handler;
+
+		/// Whether submit_control_transfer() and wait() are supported
+		virtual bool supports_async(){ return false; }
+
+		/** \brief Submit an asynchronous control out transfer, the data is copied
+		 * The transfers complete in the order they were submitted.
+		 * \return 0 if successful, otherwise a libusb error code and completed is not called
+		 */
+		virtual int submit_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			const uint8_t* data, uint16_t length, unsigned int timeout, completion_handler completed ){
+			(void)request_type; (void)request; (void)value; (void)index; (void)data; (void)length; (void)timeout; (void)completed;
+			return LIBUSB_ERROR_NOT_SUPPORTED;
+		}
+
+		/// Wait until at least one submitted transfer has completed, calls the completion handlers
+		virtual void wait(){}
+
+		/** \brief Called by rd_mouse after opening (handle of the mouse) and before closing the mouse (nullptr)
+		 * Only called if uses_device() is true.
+		 */
+		virtual void set_handle( libusb_device_handle* handle ){ (void)handle; }
+
+		/// Whether the mouse has to be opened with libusb, false if the transfers are simulated
+		virtual bool uses_device(){ return true; }
+};
+
+/// Transfers to the opened mouse with libusb, the default transport of rd_mouse
+class rd_libusb_transport : public rd_transport{
+
+	public:
+
+		int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) override;
+
+		int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) override;
+
+		bool supports_async() override{ return true; }
+
+		int submit_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			const uint8_t* data, uint16_t length, unsigned int timeout, completion_handler completed ) override;
+
+		/// Handles libusb events until a transfer has completed (libusb_handle_events_completed() allows several mice in different threads)
+		void wait() override;
+
+		void set_handle( libusb_device_handle* handle ) override{ _i_handle = handle; }
+
+	private:
+
+		libusb_device_handle* _i_handle = nullptr;
+		/// set when a transfer has completed, for libusb_handle_events_completed(), only changed with the event waiters lock held
+		int _i_completed = 0;
+
+		/// Called by libusb when an asynchronous transfer has completed
+		static void LIBUSB_CALL _i_transfer_callback( libusb_transfer* transfer );
+};
+
+/**
+ * This class holds a sequence of transfers, as recorded by rd_record_transport
+ * and played back by rd_replay_transport.
+ *
+ * File format, all numbers little endian:
+ * - header (16 bytes): magic "RDUSBREC", version (uint32), transfer count (uint32)
+ * - for each transfer (20 bytes + data): type (uint8, 0 = control, 1 = interrupt),
+ *   request type or endpoint (uint8), request (uint8), reserved (uint8), value (uint16),
+ *   index (uint16), length (uint16), reserved (uint16), result (int32), duration in
+ *   microseconds (uint32), data (length bytes: sent data for out transfers, received
+ *   data for in transfers)
+ */
+class rd_transfer_recording{
+
+	public:
+
+		/// Version of the file format, recordings with a different version are rejected
+		static const uint32_t version = 1;
+
+		/// A recorded transfer
+		struct rd_transfer{
+			/// 0 = control transfer, 1 = interrupt transfer
+			uint8_t type = 0;
+			/// bmRequestType of control transfers, endpoint of interrupt transfers
+			uint8_t request_type = 0;
+			uint8_t request = 0;
+			uint16_t value = 0;
+			uint16_t index = 0;
+			/// return value of the transfer, number of bytes or libusb error code
+			int32_t result = 0;
+			/// time the transfer took in microseconds
+			uint32_t duration = 0;
+			/// sent data (out transfers) or received data (in transfers), as long as the requested length
+			std::vector< uint8_t > data;
+
+			/// Whether data was received
+			bool is_in() const{ return request_type & 0x80; }
+		};
+
+		/// The transfers in order
+		std::vector< rd_transfer > transfers;
+
+		/** \brief Write the transfers to a file
+		 * \return 0 if successful
+		 */
+		int write( const std::string& path ) const;
+
+		/** \brief Read the transfers from a file
+		 * \return 0 if successful, 1 if the file could not be read, 2 if it is not a valid recording
+		 */
+		int read( const std::string& path );
+
+	private:
+
+		/// Size of the header in bytes
+		static const size_t _c_header_size = 16;
+		/// Size of the fixed part of a transfer in bytes
+		static const size_t _c_transfer_header_size = 20;
+
+		/// Read little endian numbers
+		static uint16_t _i_read_16( const uint8_t* data ){ return data[0] | (data[1] << 8); }
+		static uint32_t _i_read_32( const uint8_t* data ){ return _i_read_16( data ) | ((uint32_t)_i_read_16( data+2 ) << 16); }
+
+		/// Append little endian numbers
+		static void _i_append( std::string& data, uint32_t value, size_t bytes );
+};
+
+/**
+ * This class passes the transfers to another transport and records them,
+ * e.g. to capture the transfers of a real mouse for rd_replay_transport.
+ */
+class rd_record_transport : public rd_transport{
+
+	public:
+
+		/// Record the transfers performed by target
+		rd_record_transport( rd_transport& target ) : _i_target( target ) {}
+
+		int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) override;
+
+		int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) override;
+
+		void set_handle( libusb_device_handle* handle ) override{ _i_target.set_handle( handle ); }
+
+		bool uses_device() override{ return _i_target.uses_device(); }
+
+		/// Get the transfers recorded so far
+		const rd_transfer_recording& get_recording(){ return _i_recording; }
+
+	private:
+
+		rd_transport& _i_target;
+		rd_transfer_recording _i_recording;
+};
+
+/**
+ * This class plays back recorded transfers without a mouse.
+ *
+ * Each transfer is compared with the next recorded transfer: the type, the setup
+ * fields, the length and, for out transfers, the sent data have to match. Matching
+ * transfers return the recorded result and receive the recorded data, others fail
+ * with LIBUSB_ERROR_IO and are counted as mismatches (see get_mismatches()).
+ */
+class rd_replay_transport : public rd_transport{
+
+	public:
+
+		/// Replay the transfers of recording
+		rd_replay_transport( const rd_transfer_recording& recording ) : _i_recording( recording ) {}
+
+		int control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint8_t* data, uint16_t length, unsigned int timeout ) override;
+
+		int interrupt_transfer( uint8_t endpoint, uint8_t* data, int length, int* transferred, unsigned int timeout ) override;
+
+		bool uses_device() override{ return false; }
+
+		/** \brief Set the time each transfer takes in microseconds (default 0)
+		 * \arg recorded if true, each transfer takes as long as it took when it was recorded
+		 */
+		void set_latency( unsigned int latency, bool recorded = false ){
+			_i_latency = latency;
+			_i_recorded_latency = recorded;
+		}
+
+		/// Start again with the first recorded transfer and reset the mismatches
+		void rewind(){
+			_i_position = 0;
+			_i_mismatches = 0;
+		}
+
+		/// Number of transfers that did not match the recording (including transfers after the end of the recording)
+		unsigned int get_mismatches(){ return _i_mismatches; }
+
+		/// Number of recorded transfers that have not been replayed
+		size_t get_remaining(){ return _i_recording.transfers.size() - _i_position; }
+
+	private:
+
+		rd_transfer_recording _i_recording;
+		/// index of the next transfer
+		size_t _i_position = 0;
+		unsigned int _i_mismatches = 0;
+		unsigned int _i_latency = 0;
+		bool _i_recorded_latency = false;
+
+		/** \brief Play back the next transfer if it matches
+		 * \arg transfer the transfer as performed, data is replaced by the recorded data for in transfers
+		 * \return the recorded result or LIBUSB_ERROR_IO
+		 */
+		int _i_replay( rd_transfer_recording::rd_transfer& transfer );
+};
+
+#endif
@@ -25,11 +25,27 @@
 #include <regex>
 #include <type_traits>
 #include <variant>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include <chrono>
 #include <getopt.h>
+#include <poll.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
 
 #include "include/rd_mouse.h"
-#include "include/load_config.h"
+#include "include/rd_config.h"
 #include "include/help.h"
+#include "include/daemon.h"
+#include "include/packet_image.h"
+#include "include/snapshot_file.h"
+#include "include/led_stream.h"
+#include "include/latency_histogram.h"
+#include "include/transport.h"
+#include "include/emulator.h"
 
 // this is the default version string
 // the version string gets overwritten by the makefile
@@ -46,12 +62,159 @@ template< typename T1, typename T2 > struct overload : T1, T2  {
 };
 
 
+// values for long options without a short option
+enum long_only_option{
+	option_daemon = 256,
+	option_socket,
+	option_diff,
+	option_verify,
+	option_transfer_window,
+	option_transfer_timeout,
+	option_operation_timeout,
+	option_all,
+	option_watch,
+	option_compile,
+	option_apply,
+	option_backup,
+	option_restore,
+	option_only,
+	option_stream,
+	option_dpi,
+	option_switch_latency,
+	option_record,
+	option_replay,
+	option_emulate
+};
+
+
+// this struct holds the parsed command line options
+struct cli_options{
+	bool flag_config = false, flag_profile = false;
+	bool flag_macro = false, flag_number = false;
+	bool flag_bus = false, flag_device = false;
+	bool flag_kernel_driver = false;
+	bool flag_dump_settings = false;
+	bool flag_read_settings = false;
+	bool flag_daemon = false, flag_socket = false;
+	bool flag_diff = false;
+	bool flag_verify = false;
+	bool flag_all = false;
+	bool flag_watch = false;
+	bool flag_compile = false, flag_apply = false;
+	bool flag_backup = false, flag_restore = false;
+	bool flag_only = false;
+	bool flag_stream = false;
+	bool flag_dpi = false;
+	bool flag_switch_latency = false;
+	bool flag_record = false, flag_replay = false;
+	bool flag_emulate = false;
+	
+	std::string string_config, string_profile;
+	std::string string_macro, string_number;
+	std::string string_bus, string_device;
+	std::string string_dump, string_read;
+	std::string string_model = "";
+	std::string string_daemon, string_socket;
+	std::string string_compile, string_apply;
+	std::string string_backup, string_restore;
+	std::string string_only;
+	std::string string_dpi;
+	std::string string_record, string_replay;
+	unsigned int transfer_window = 1;
+	unsigned int transfer_timeout = 1000, operation_timeout = 0;
+	unsigned int stream_rate = 0;
+	unsigned int switch_count = 0;
+};
+
+
+// this function parses the command line options,
+// returns -1 if the program should continue, otherwise the exit status (e.g. after --help)
+int parse_options( int argc, char **argv, cli_options &options, std::ostream &output );
+
+
+// this function sets the transfer window and the timeouts of the mouse
+template< typename T > void set_transfer_options( T &m, const cli_options &options ){
+	m.set_transfer_window( options.transfer_window );
+	m.set_transfer_timeout( options.transfer_timeout );
+	m.set_operation_timeout( options.operation_timeout );
+}
+
+
+// this function throws std::string if a transfer of the current operation of the mouse failed
+template< typename T > void check_transfers( T &m, const std::string &action ){
+	if( m.get_transfer_error() != 0 )
+		throw std::string( "Couldn't "+action+": "+libusb_error_name( m.get_transfer_error() )+"." );
+}
+
+
+// this function reports the result of a write with --verify,
+// throws std::string if the mouse still holds different data after re-sending
+template< typename T > void check_verification( T &m, int mismatches, const std::string &data, std::ostream &error_output ){
+	
+	if( m.get_resent_packets() < 0 ){
+		error_output << "Verification is not supported by this mouse.\n";
+		return;
+	}
+	
+	if( mismatches != 0 )
+		throw std::string( "Couldn't verify "+data+": "+std::to_string( mismatches )+" packets differ after re-sending." );
+	
+	error_output << "Verification: "+data+" match, re-sent " << m.get_resent_packets() << " packets.\n";
+}
+
+
 // this function checks its arguments and opens the mouse accordingly
 // (with vid and pid or with bus and device)
 template< typename T >int open_mouse_wrapper( T &m, const bool flag_bus, const bool flag_device,
 	const std::string &string_bus, const std::string &string_device );
 
 
+// this function performs all actions specified by options on an opened mouse,
+// throws std::string in case of an error
+template< typename T > void perform_actions( T &m, const cli_options &options,
+	std::ostream &output, std::ostream &error_output );
+
+
+// this function keeps the opened mouse and performs the requests received on the socket
+// specified with --daemon, until SIGINT or SIGTERM is received
+template< typename T > void serve_requests( T &m, const cli_options &daemon_options );
+
+
+// this function opens all detected mice and performs all actions on them in parallel,
+// one thread per mouse, prints the results per mouse and returns the exit status
+int perform_actions_all( const cli_options &options );
+
+
+// this function prepares the packets for all actions once and sends them
+// to every matching mouse as soon as it is connected, until SIGINT or SIGTERM is received
+void watch_and_apply( const cli_options &options );
+
+
+// this function streams the colors read from stdin (rrggbb, one per line) to the LED of the profile
+// given with -p (default 1), until the end of the input or SIGINT or SIGTERM
+template< typename T > void stream_colors( T &m, const cli_options &options, std::ostream &error_output );
+
+
+// this function prepares the packets for all actions without an opened mouse,
+// returns false if the mouse does not support this (wireless mice)
+bool prepare_packets( rd_mouse::mouse_variant &mouse, const cli_options &options,
+	std::vector< rd_mouse::rd_packet > &packets );
+
+
+// this function prepares the packets for all actions and writes them to the packet image
+// specified with --compile
+void compile_image( const cli_options &options );
+
+
+// this function sends the packets from the packet image specified with --apply to the mouse
+void apply_image( const cli_options &options );
+
+
+// this function converts the snapshot specified with --restore into the packets
+// of the writer functions and sends them to the mouse
+void restore_snapshot( const cli_options &options );
+
+
 
 // main function
 int main( int argc, char **argv ){
@@ -63,110 +226,155 @@ int main( int argc, char **argv ){
 			return 0;
 		}
 		
-		//command line options
-		static struct option long_options[] = {
-			{"help", no_argument, 0, 'h'},
-			{"config", required_argument, 0, 'c'},
-			{"profile", required_argument, 0, 'p'},
-			{"macro", required_argument, 0, 'm'},
-			{"number", required_argument, 0, 'n'},
-			{"bus", required_argument, 0, 'b'},
-			{"device", required_argument, 0, 'd'},
-			{"kernel-driver", no_argument, 0, 'k'},
-			{"version", no_argument, 0, 'v'},
-			{"dump", required_argument, 0, 'D'},
-			{"read", required_argument, 0, 'R'},
-			{"model", required_argument, 0, 'M'},
-			{0, 0, 0, 0}
-		};
-		
-		bool flag_config = false, flag_profile = false;
-		bool flag_macro = false, flag_number = false;
-		bool flag_bus = false, flag_device = false;
-		bool flag_kernel_driver = false;
-		bool flag_dump_settings = false;
-		bool flag_read_settings = false;
-		
-		std::string string_config, string_profile;
-		std::string string_macro, string_number;
-		std::string string_bus, string_device;
-		std::string string_dump, string_read;
-		std::string string_model = "";
-		
 		//parse command line options
-		int c, option_index = 0;
-		while( (c = getopt_long( argc, argv, "hc:p:m:n:b:d:kvD:R:M:",
-		long_options, &option_index ) ) != -1 ){
-			
-			switch( c ){
-				case 'h':
-					std::cout << mouse_m908_help;
-					return 0;
-					break;
-				case 'c':
-					flag_config = true;
-					string_config = optarg;
-					break;
-				case 'p':
-					flag_profile = true;
-					string_profile = optarg;
-					break;
-				case 'm':
-					flag_macro = true;
-					string_macro = optarg;
-					break;
-				case 'n':
-					flag_number = true;
-					string_number = optarg;
-					break;
-				case 'b':
-					flag_bus = true;
-					string_bus = optarg;
-					break;
-				case 'd':
-					flag_device = true;
-					string_device = optarg;
-					break;
-				case 'k':
-					flag_kernel_driver = true;
-					break;
-				case 'v':
-					std::cout << "Version: " << VERSION_STRING << "\n";
-					return 0;
-					break;
-				case 'D':
-					flag_dump_settings = true;
-					string_dump = optarg;
-					break;
-				case 'R':
-					flag_read_settings = true;
-					string_read = optarg;
-					break;
-				case 'M':
-					string_model = optarg;
-					break;
-				case '?':
-					break;
-				default:
-					break;
-			}
-		}
+		cli_options options;
+		int parse_result = parse_options( argc, argv, options, std::cout );
+		if( parse_result >= 0 )
+			return parse_result;
 
 		// print a list of valid model names
-		if( string_model == "?" ){
-			variant_loop<rd_mouse::mouse_variant>( [](auto m){
-				if( m.get_name() != rd_mouse::monostate::get_name() )
-					std::cout << m.get_name() << "\n";
-			} );
+		if( options.string_model == "?" ){
+			for( size_t i = rd_mouse::model_registry::model_count(); i-- > 0; ){
+				if( rd_mouse::model_registry::model_name( i ) != rd_mouse::monostate::get_name() )
+					std::cout << rd_mouse::model_registry::model_name( i ) << "\n";
+			}
+			return 0;
+		}
+		
+		// partial reads, a backup needs all settings
+		if( options.flag_only ){
+			
+			if( !options.flag_dump_settings && !options.flag_read_settings )
+				throw std::string( "--only can only be used with --dump or --read." );
+			
+			if( options.flag_backup )
+				throw std::string( "--only can not be used with --backup." );
+		}
+		
+		// LED streaming reads the colors from stdin
+		if( options.flag_stream && ( options.flag_all || options.flag_watch || options.flag_daemon ) )
+			throw std::string( "--stream can not be used with --all, --watch or --daemon." );
+		
+		// recorded transfers, only for a single mouse opened by this process
+		if( options.flag_record || options.flag_replay ){
+			
+			if( options.flag_record && options.flag_replay )
+				throw std::string( "--record and --replay can not be used together." );
+			
+			if( options.flag_socket || options.flag_daemon || options.flag_watch || options.flag_all ||
+				options.flag_compile || options.flag_apply || options.flag_restore || options.flag_stream )
+				throw std::string( "--record and --replay can not be used with --socket, --daemon, --watch, --all, --compile, --apply, --restore or --stream." );
+			
+			if( options.flag_replay && options.string_model == "" )
+				throw std::string( "Missing option, --replay requires --model." );
+		}
+		
+		// emulated mouse, can be recorded and kept by a daemon
+		if( options.flag_emulate ){
+			
+			if( options.flag_replay || options.flag_socket || options.flag_watch || options.flag_all ||
+				options.flag_compile || options.flag_apply || options.flag_restore )
+				throw std::string( "--emulate can not be used with --replay, --socket, --watch, --all, --compile, --apply or --restore." );
+			
+			if( options.string_model == "" )
+				throw std::string( "Missing option, --emulate requires --model." );
+		}
+		
+		// packet images
+		if( options.flag_compile || options.flag_apply ){
+			
+			if( options.flag_compile && options.flag_apply )
+				throw std::string( "--compile and --apply can not be used together." );
+			
+			if( options.flag_socket || options.flag_daemon || options.flag_watch || options.flag_all ||
+				options.flag_diff || options.flag_verify || options.flag_dump_settings || options.flag_read_settings ||
+				options.flag_backup || options.flag_restore || options.flag_stream || options.flag_switch_latency )
+				throw std::string( "--compile and --apply can not be used with --socket, --daemon, --watch, --all, --diff, --verify, --dump, --read, --backup, --restore, --stream or --switch-latency." );
+			
+			if( options.flag_compile ){
+				compile_image( options );
+			} else{
+				if( options.flag_config || options.flag_profile || options.flag_macro || options.flag_number || options.flag_dpi )
+					throw std::string( "--apply can not be used with --config, --profile, --macro, --number or --dpi, these are stored in the packet image." );
+				apply_image( options );
+			}
+			
+			return 0;
+		}
+		
+		// restore a snapshot written by --backup
+		if( options.flag_restore ){
+			
+			if( options.flag_socket || options.flag_daemon || options.flag_watch || options.flag_all ||
+				options.flag_diff || options.flag_verify || options.flag_dump_settings || options.flag_read_settings || options.flag_backup ||
+				options.flag_stream || options.flag_config || options.flag_profile || options.flag_macro || options.flag_number ||
+				options.flag_dpi || options.flag_switch_latency )
+				throw std::string( "--restore can only be used with --model, --bus, --device, --kernel-driver, --transfer-window and the timeouts." );
+			
+			restore_snapshot( options );
+			return 0;
+		}
+		
+		// send the arguments to a running daemon instead of opening the mouse
+		if( options.flag_socket ){
+			
+			if( options.flag_daemon )
+				throw std::string( "--daemon and --socket can not be used together." );
+			
+			std::vector< std::string > args( argv+1, argv+argc );
+			return rd_daemon::send_request( options.string_socket, args, std::cout, std::cerr );
+		}
+		
+		// apply the actions to every mouse that gets connected
+		if( options.flag_watch ){
+			
+			if( options.flag_all || options.flag_bus || options.flag_device || options.flag_daemon ||
+				options.flag_diff || options.flag_dump_settings || options.flag_read_settings || options.flag_backup ||
+				options.flag_switch_latency )
+				throw std::string( "--watch can not be used with --all, --bus, --device, --daemon, --diff, --dump, --read, --backup or --switch-latency." );
+			
+			watch_and_apply( options );
 			return 0;
 		}
 		
+		// open all mice and perform the actions on each of them
+		if( options.flag_all ){
+			
+			if( options.flag_bus || options.flag_device || options.flag_daemon || options.flag_backup )
+				throw std::string( "--all can not be used with --bus, --device, --daemon or --backup." );
+			
+			return perform_actions_all( options );
+		}
+		
+		// transfers recorded with --record, played back instead of opening the mouse
+		rd_transfer_recording recording;
+		if( options.flag_replay ){
+			int read_result = recording.read( options.string_replay );
+			if( read_result == 1 )
+				throw std::string( "Couldn't open "+options.string_replay );
+			if( read_result == 2 )
+				throw std::string( options.string_replay+" is not a valid recording." );
+		}
+		
+		rd_libusb_transport usb_transport;
+		rd_emulator emulator;
+		rd_record_transport record_transport( options.flag_emulate ? (rd_transport&)emulator : (rd_transport&)usb_transport );
+		rd_replay_transport replay_transport( recording );
+		
 		rd_mouse::mouse_variant mouse;
 		
-		if( string_model == "" )
+		if( options.flag_replay || options.flag_emulate )
+			mouse = rd_mouse::create(options.string_model);
+		else if( options.string_model == "" )
 			mouse = rd_mouse::detect();
 		else
-			mouse = rd_mouse::detect(string_model);
+			mouse = rd_mouse::detect(options.string_model);
+		
+		if( ( options.flag_replay || options.flag_emulate ) && std::holds_alternative<rd_mouse::monostate>(mouse) )
+			throw std::string( "Unknown model "+options.string_model+" (--model ? for a list of valid models)." );
+		
+		if( options.flag_emulate && std::visit( [](auto& m){ return std::is_base_of_v< rd_mouse_wireless, std::decay_t<decltype(m)> >; }, mouse ) )
+			throw std::string( "--emulate only supports the wired mice." );
 		
 		if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
 			throw std::string( 
@@ -177,185 +385,31 @@ int main( int argc, char **argv ){
 			);
 		}
 		
-		// lambda function to perform all actions on the mouse
-		auto perform_actions = overload(
+		// lambda function to open the mouse, perform all actions (or run the daemon) and close the mouse
+		auto open_and_perform_actions = overload(
 			[](rd_mouse::monostate){},
 			[&](auto& m){
 
 				// set whether to detach kernel driver
-				m.set_detach_kernel_driver( !flag_kernel_driver );
+				m.set_detach_kernel_driver( !options.flag_kernel_driver );
+				
+				// record, replay or emulate the transfers
+				if( options.flag_record )
+					m.set_transport( &record_transport );
+				else if( options.flag_replay )
+					m.set_transport( &replay_transport );
+				else if( options.flag_emulate )
+					m.set_transport( &emulator );
 				
 				// open mouse, throws std::string in case of an error, handling in main()
-				open_mouse_wrapper( m, flag_bus, flag_device, string_bus, string_device );
+				open_mouse_wrapper( m, options.flag_bus, options.flag_device, options.string_bus, options.string_device );
 				
 				try{
-					// read settings and dump raw data
-					if( flag_dump_settings ){
-						
-						// dump to file or cout
-						if( string_dump != "-" ){
-							std::ofstream out( string_dump );
-							
-							if( out.is_open() ){				
-								// dump settings
-								m.dump_settings( out );
-							
-								out.close();
-							} else{
-								throw std::string( "Couldn't open "+string_dump );
-							}
-						} else{
-							m.dump_settings( std::cout );
-						}
-						
-					}
-					
-					// read settings and print in .ini format
-					if( flag_read_settings ){
-						
-						// dump to file or cout
-						if( string_read != "-" ){
-							std::ofstream out( string_read );
-							
-							if( out.is_open() ){
-								out << "# Model: " << m.get_name() << "\n";
-								// read settings
-								m.read_and_print_settings( out );
-							
-								out.close();
-							} else{
-								throw std::string( "Couldn't open "+string_read );
-							}
-						} else{
-							std::cout << "# Model: " << m.get_name() << "\n";
-							m.read_and_print_settings( std::cout );
-						}
-						
-					}
-					
-					// load and write config
-					if( flag_config ){
-						
-						simple_ini_parser pt;
-						if( pt.read_ini( string_config ) != 0 )
-							throw std::string( "Could not open configuration file." );
-						
-						//parse config file
-						for( int i = 1; i < 6; i++ ){
-							
-							rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(i - 1);
-
-							for( auto& lightmode : m.lightmode_strings() ){
-								if( pt.get("profile"+std::to_string(i)+".lightmode", "") == lightmode.second )
-									m.set_lightmode( profile, lightmode.first );
-							}
-
-							if( std::regex_match( pt.get("profile"+std::to_string(i)+".color", ""), std::regex("[0-9a-fA-F]{6}") ) ){
-								m.set_color( profile,
-								{(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(0,2), 0, 16),
-								(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(2,2), 0, 16), 
-								(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(4,2), 0, 16)} );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".brightness", "").length() != 0 ){
-								m.set_brightness( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".brightness", ""), 0, 16) );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".speed", "").length() != 0 ){
-								m.set_speed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".speed", ""), 0, 16) );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".scrollspeed", "").length() != 0 ){
-								m.set_scrollspeed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".scrollspeed", ""), 0, 16) );
-							}
-							
-							// DPI
-							for( int j = 1; j < 6; j++ ){
-								
-								// DPI level disabled
-								if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j)+"_enable", "") == "0" )
-									m.set_dpi_enable( profile, j-1, false );
-								
-								// DPI value
-								if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "").length() != 0 ){ // non-empty dpi value
-									
-									if( m.set_dpi( profile, j-1, pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") ) != 0 ) // if invalid dpi value
-										std::cerr << "Warning: Unknown DPI value " << pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") << "\n";
-								}
-							}
-							
-							for( auto& report_rate : m.report_rate_strings() ){
-								if( pt.get("profile"+std::to_string(i)+".report_rate", "") == report_rate.second )
-									m.set_report_rate( profile, report_rate.first );
-							}
-
-							// button mapping
-							for( auto key : m.button_names() ){
-								if( pt.get("profile"+std::to_string(i)+"."+key.second, "").length() != 0 ){ m.set_key_mapping( profile, key.first, pt.get("profile"+std::to_string(i)+"."+key.second, "") );	}
-							}
-							
-						}
-						
-						// write settings
-						m.write_settings();
-						
-					}
-					
-					// change active profile
-					if( flag_profile ){
-						
-						// set profile
-						if( !std::regex_match( string_profile, std::regex("[1-5]") ) )
-							throw std::string( "Wrong argument, expected 1-5." );
-
-						m.set_profile( (rd_mouse::rd_profile)(std::stoi(string_profile) - 1) );
-
-						// write profile
-						m.write_profile();
-						
-					}
-					
-					// send all macros
-					if( flag_macro && !flag_number ){
-						
-						// load macros
-						int r = m.set_all_macros( string_macro );
-						
-						if( r != 0 )
-							throw std::string( "Couldn't load macros." );
-						
-						// write macros
-						for( int i = 1; i < 16; i++ )
-							m.write_macro(i);
-						
-					}
 					
-					// send individual macro
-					if( flag_macro && flag_number ){
-						
-						
-						// set macro and macro slot (number)
-						int number;
-						
-						if( std::regex_match( string_number, std::regex("[0-9]+") ) ){
-							number = (int)stoi(string_number);
-						} else{
-							throw std::string( "Wrong argument, expected 1-15." );
-						}
-						
-						if( number < 1 || number > 15 )
-							throw std::string( "Wrong argument, expected 1-15." );
-						
-						if( m.set_macro( number, string_macro ) != 0 )
-							throw std::string( "Couldn't load macro" );
-						
-						// write macro
-						m.write_macro(number);
-						
-					} else if( !flag_macro && flag_number ){
-						throw std::string( "Misssing option, --macro and --number must be used together." );
-					}
-				
+					if( options.flag_daemon )
+						serve_requests( m, options );
+					else
+						perform_actions( m, options, std::cout, std::cerr );
 				
 				// error handling
 				} catch( std::string const &message ){ // close mouse, rethrow
@@ -376,7 +430,16 @@ int main( int argc, char **argv ){
 			}
 		);
 
-		std::visit( [&](auto&& arg){ perform_actions(arg); }, mouse );
+		std::visit( [&](auto&& arg){ open_and_perform_actions(arg); }, mouse );
+		
+		if( options.flag_record && record_transport.get_recording().write( options.string_record ) != 0 )
+			throw std::string( "Couldn't write "+options.string_record );
+		
+		// the recording has to be played back completely
+		if( options.flag_replay && ( replay_transport.get_mismatches() != 0 || replay_transport.get_remaining() != 0 ) )
+			throw std::string( "The transfers differ from "+options.string_replay+": "+
+				std::to_string( replay_transport.get_mismatches() )+" transfers did not match, "+
+				std::to_string( replay_transport.get_remaining() )+" recorded transfers were not performed." );
 
 	} catch( std::string const &message ){ // print error message and quit
 		
@@ -393,6 +456,935 @@ int main( int argc, char **argv ){
 	return 0;
 }
 
+int parse_options( int argc, char **argv, cli_options &options, std::ostream &output ){
+	
+	//command line options
+	static struct option long_options[] = {
+		{"help", no_argument, 0, 'h'},
+		{"config", required_argument, 0, 'c'},
+		{"profile", required_argument, 0, 'p'},
+		{"macro", required_argument, 0, 'm'},
+		{"number", required_argument, 0, 'n'},
+		{"bus", required_argument, 0, 'b'},
+		{"device", required_argument, 0, 'd'},
+		{"kernel-driver", no_argument, 0, 'k'},
+		{"version", no_argument, 0, 'v'},
+		{"dump", required_argument, 0, 'D'},
+		{"read", required_argument, 0, 'R'},
+		{"model", required_argument, 0, 'M'},
+		{"daemon", required_argument, 0, option_daemon},
+		{"socket", required_argument, 0, option_socket},
+		{"diff", no_argument, 0, option_diff},
+		{"verify", no_argument, 0, option_verify},
+		{"transfer-window", required_argument, 0, option_transfer_window},
+		{"transfer-timeout", required_argument, 0, option_transfer_timeout},
+		{"operation-timeout", required_argument, 0, option_operation_timeout},
+		{"all", no_argument, 0, option_all},
+		{"watch", no_argument, 0, option_watch},
+		{"compile", required_argument, 0, option_compile},
+		{"apply", required_argument, 0, option_apply},
+		{"backup", required_argument, 0, option_backup},
+		{"restore", required_argument, 0, option_restore},
+		{"only", required_argument, 0, option_only},
+		{"stream", required_argument, 0, option_stream},
+		{"dpi", required_argument, 0, option_dpi},
+		{"switch-latency", required_argument, 0, option_switch_latency},
+		{"record", required_argument, 0, option_record},
+		{"replay", required_argument, 0, option_replay},
+		{"emulate", no_argument, 0, option_emulate},
+		{0, 0, 0, 0}
+	};
+	
+	// reset getopt, this is required to parse the requests in daemon mode
+	#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+	optreset = 1;
+	optind = 1;
+	#else
+	optind = 0;
+	#endif
+	
+	int c, option_index = 0;
+	while( (c = getopt_long( argc, argv, "hc:p:m:n:b:d:kvD:R:M:",
+	long_options, &option_index ) ) != -1 ){
+		
+		switch( c ){
+			case 'h':
+				output << mouse_m908_help;
+				return 0;
+				break;
+			case 'c':
+				options.flag_config = true;
+				options.string_config = optarg;
+				break;
+			case 'p':
+				options.flag_profile = true;
+				options.string_profile = optarg;
+				break;
+			case 'm':
+				options.flag_macro = true;
+				options.string_macro = optarg;
+				break;
+			case 'n':
+				options.flag_number = true;
+				options.string_number = optarg;
+				break;
+			case 'b':
+				options.flag_bus = true;
+				options.string_bus = optarg;
+				break;
+			case 'd':
+				options.flag_device = true;
+				options.string_device = optarg;
+				break;
+			case 'k':
+				options.flag_kernel_driver = true;
+				break;
+			case 'v':
+				output << "Version: " << VERSION_STRING << "\n";
+				return 0;
+				break;
+			case 'D':
+				options.flag_dump_settings = true;
+				options.string_dump = optarg;
+				break;
+			case 'R':
+				options.flag_read_settings = true;
+				options.string_read = optarg;
+				break;
+			case 'M':
+				options.string_model = optarg;
+				break;
+			case option_daemon:
+				options.flag_daemon = true;
+				options.string_daemon = optarg;
+				break;
+			case option_socket:
+				options.flag_socket = true;
+				options.string_socket = optarg;
+				break;
+			case option_diff:
+				options.flag_diff = true;
+				break;
+			case option_verify:
+				options.flag_verify = true;
+				break;
+			case option_transfer_window:
+				if( !std::regex_match( optarg, std::regex("[1-9][0-9]{0,2}") ) )
+					throw std::string( "Wrong argument, expected 1-999." );
+				options.transfer_window = std::stoi( optarg );
+				break;
+			case option_transfer_timeout:
+				if( !std::regex_match( optarg, std::regex("[1-9][0-9]{0,5}") ) )
+					throw std::string( "Wrong argument, expected 1-999999 (milliseconds)." );
+				options.transfer_timeout = std::stoi( optarg );
+				break;
+			case option_operation_timeout:
+				if( !std::regex_match( optarg, std::regex("[1-9][0-9]{0,5}") ) )
+					throw std::string( "Wrong argument, expected 1-999999 (milliseconds)." );
+				options.operation_timeout = std::stoi( optarg );
+				break;
+			case option_stream:
+				if( !std::regex_match( optarg, std::regex("[1-9][0-9]{0,3}") ) )
+					throw std::string( "Wrong argument, expected 1-9999 (frames per second)." );
+				options.flag_stream = true;
+				options.stream_rate = std::stoi( optarg );
+				break;
+			case option_dpi:
+				if( !std::regex_match( optarg, std::regex("[1-5]:[^,]+(,[^,]+){0,4}") ) )
+					throw std::string( "Wrong argument for --dpi, expected profile:dpi1,dpi2,... (profile 1-5, up to 5 levels)." );
+				options.flag_dpi = true;
+				options.string_dpi = optarg;
+				break;
+			case option_switch_latency:
+				if( !std::regex_match( optarg, std::regex("[1-9][0-9]{0,4}") ) )
+					throw std::string( "Wrong argument, expected 1-99999 (number of profile switches)." );
+				options.flag_switch_latency = true;
+				options.switch_count = std::stoi( optarg );
+				break;
+			case option_record:
+				options.flag_record = true;
+				options.string_record = optarg;
+				break;
+			case option_replay:
+				options.flag_replay = true;
+				options.string_replay = optarg;
+				break;
+			case option_emulate:
+				options.flag_emulate = true;
+				break;
+			case option_all:
+				options.flag_all = true;
+				break;
+			case option_watch:
+				options.flag_watch = true;
+				break;
+			case option_compile:
+				options.flag_compile = true;
+				options.string_compile = optarg;
+				break;
+			case option_apply:
+				options.flag_apply = true;
+				options.string_apply = optarg;
+				break;
+			case option_backup:
+				options.flag_backup = true;
+				options.string_backup = optarg;
+				break;
+			case option_restore:
+				options.flag_restore = true;
+				options.string_restore = optarg;
+				break;
+			case option_only:
+				if( rd_mouse::rd_read_selection().parse( optarg ) != 0 )
+					throw std::string( "Wrong argument for --only, see --help for the sections." );
+				options.flag_only = true;
+				options.string_only = optarg;
+				break;
+			case '?':
+				break;
+			default:
+				break;
+		}
+	}
+	
+	return -1;
+}
+
+template< typename T > void perform_actions( T &m, const cli_options &options,
+	std::ostream &output, std::ostream &error_output ){
+	
+	// number of transfers in flight for the writer functions and the timeouts
+	set_transfer_options( m, options );
+	
+	// read the settings once, shared by --backup, --dump and --read
+	// (with --only just the selected sections)
+	rd_mouse::rd_read_selection selection;
+	if( options.flag_only )
+		selection.parse( options.string_only );
+	
+	rd_mouse::rd_device_snapshot snapshot;
+	if( options.flag_backup || options.flag_dump_settings || options.flag_read_settings ){
+		m.begin_operation();
+		m.read_snapshot( snapshot, selection );
+		check_transfers( m, "read the settings" );
+	}
+	
+	// write the raw responses to a snapshot file
+	if( options.flag_backup ){
+		
+		if( snapshot.parts.empty() )
+			throw std::string( "Backups are not supported by this mouse." );
+		if( !snapshot.complete() )
+			throw std::string( "Couldn't read the settings from the mouse." );
+		
+		uint16_t vid = 0, pid = 0;
+		m.get_vid_pid( vid, pid );
+		
+		if( rd_snapshot_file::write( options.string_backup, m.get_name(), vid, pid, snapshot ) != 0 )
+			throw std::string( "Couldn't write "+options.string_backup );
+		
+	}
+	
+	// dump raw data
+	if( options.flag_dump_settings ){
+		
+		// dump to file or output
+		if( options.string_dump != "-" ){
+			std::ofstream out( options.string_dump );
+			
+			if( out.is_open() ){				
+				// dump settings
+				m.dump_settings( snapshot, out );
+			
+				out.close();
+			} else{
+				throw std::string( "Couldn't open "+options.string_dump );
+			}
+		} else{
+			m.dump_settings( snapshot, output );
+		}
+		
+	}
+	
+	// print settings in .ini format
+	if( options.flag_read_settings ){
+		
+		// dump to file or output
+		if( options.string_read != "-" ){
+			std::ofstream out( options.string_read );
+			
+			if( out.is_open() ){
+				out << "# Model: " << m.get_name() << "\n";
+				// print settings
+				m.read_and_print_settings( snapshot, out );
+			
+				out.close();
+			} else{
+				throw std::string( "Couldn't open "+options.string_read );
+			}
+		} else{
+			output << "# Model: " << m.get_name() << "\n";
+			m.read_and_print_settings( snapshot, output );
+		}
+		
+	}
+	
+	// load and write config
+	if( options.flag_config ){
+		
+		// resolve the configuration once, nothing is sent if any value is invalid
+		rd_config config;
+		std::vector< std::string > errors;
+		
+		if( config.load( options.string_config, m.lightmode_strings(), m.report_rate_strings(), m.button_names(), errors ) != 0 )
+			throw std::string( "Could not open configuration file." );
+		
+		config.apply( m, errors );
+		
+		// report all errors together
+		if( !errors.empty() ){
+			std::string message = "Invalid configuration, nothing was sent:";
+			for( auto& error : errors )
+				message += "\n- " + error;
+			throw message;
+		}
+		
+		// write settings, in daemon mode only the rows changed since the last request are sent
+		m.set_differential_write( options.flag_diff );
+		m.set_verify( options.flag_verify );
+		m.begin_operation();
+		int mismatches = m.write_changes();
+		check_transfers( m, "write the settings" );
+		
+		if( options.flag_diff ){
+			if( m.get_skipped_packets() < 0 )
+				error_output << "Differential write is not supported by this mouse, all packets were sent.\n";
+			else
+				error_output << "Differential write: skipped " << m.get_skipped_packets() << " unchanged packets.\n";
+		}
+		
+		if( options.flag_verify )
+			check_verification( m, mismatches, "the settings", error_output );
+		
+	}
+	
+	// set the dpi levels of one profile, only the dpi rows are sent
+	if( options.flag_dpi ){
+		
+		rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(options.string_dpi[0] - '1');
+		
+		std::vector< std::string > levels;
+		std::stringstream level_stream( options.string_dpi.substr( 2 ) );
+		for( std::string level; std::getline( level_stream, level, ',' ); )
+			levels.push_back( level );
+		
+		// the given levels are enabled before the others are disabled, at least one level stays enabled
+		for( size_t i = 0; i < levels.size(); i++ ){
+			if( m.set_dpi( profile, i, levels[i] ) != 0 )
+				throw std::string( "Unknown DPI value "+levels[i] );
+			m.set_dpi_enable( profile, i, true );
+		}
+		for( size_t i = levels.size(); i < 5; i++ )
+			m.set_dpi_enable( profile, i, false );
+		
+		m.set_verify( options.flag_verify );
+		m.begin_operation();
+		int mismatches = m.write_dpi( profile );
+		check_transfers( m, "write the DPI levels" );
+		
+		if( options.flag_verify )
+			check_verification( m, mismatches, "the DPI levels", error_output );
+		
+	}
+	
+	// change active profile
+	if( options.flag_profile ){
+		
+		// set profile
+		if( !std::regex_match( options.string_profile, std::regex("[1-5]") ) )
+			throw std::string( "Wrong argument, expected 1-5." );
+
+		rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(std::stoi(options.string_profile) - 1);
+		
+		// measure the latency of the profile switches, alternating with the next profile,
+		// the last switch is to the specified profile
+		if( options.flag_switch_latency ){
+			
+			rd_latency_histogram histogram;
+			for( unsigned int i = options.switch_count; i > 0; i-- ){
+				
+				m.set_profile( ( i % 2 == 0 ) ? (rd_mouse::rd_profile)((profile+1) % 5) : profile );
+				
+				auto start = std::chrono::steady_clock::now();
+				m.begin_operation();
+				m.write_changes();
+				histogram.add( std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count() );
+				
+				check_transfers( m, "write the profile" );
+			}
+			
+			histogram.print( "Profile switch", error_output );
+			
+		} else{
+			
+			m.set_profile( profile );
+			
+			// write profile
+			m.begin_operation();
+			m.write_changes();
+			check_transfers( m, "write the profile" );
+		}
+		
+	} else if( options.flag_switch_latency ){
+		throw std::string( "Missing option, --switch-latency requires --profile." );
+	}
+	
+	// send all macros
+	if( options.flag_macro && !options.flag_number ){
+		
+		// load macros
+		int r = m.set_all_macros( options.string_macro );
+		
+		if( r != 0 )
+			throw std::string( "Couldn't load macros." );
+		
+		// write the changed macros
+		m.set_verify( options.flag_verify );
+		m.begin_operation();
+		int mismatches = m.write_changes();
+		check_transfers( m, "write the macros" );
+		
+		if( options.flag_verify )
+			check_verification( m, mismatches, "the macros", error_output );
+		
+	}
+	
+	// send individual macro
+	if( options.flag_macro && options.flag_number ){
+		
+		
+		// set macro and macro slot (number)
+		int number;
+		
+		if( std::regex_match( options.string_number, std::regex("[0-9]+") ) ){
+			number = (int)stoi(options.string_number);
+		} else{
+			throw std::string( "Wrong argument, expected 1-15." );
+		}
+		
+		if( number < 1 || number > 15 )
+			throw std::string( "Wrong argument, expected 1-15." );
+		
+		if( m.set_macro( number, options.string_macro ) != 0 )
+			throw std::string( "Couldn't load macro" );
+		
+		// write macro
+		m.set_verify( options.flag_verify );
+		m.begin_operation();
+		int mismatches = m.write_changes();
+		check_transfers( m, "write the macro" );
+		
+		if( options.flag_verify )
+			check_verification( m, mismatches, "the macro", error_output );
+		
+	} else if( !options.flag_macro && options.flag_number ){
+		throw std::string( "Misssing option, --macro and --number must be used together." );
+	}
+	
+	// stream LED colors after all other actions
+	if( options.flag_stream )
+		stream_colors( m, options, error_output );
+	
+}
+
+template< typename T > void serve_requests( T &m, const cli_options &daemon_options ){
+	
+	int res = rd_daemon::serve( daemon_options.string_daemon,
+		[&]( const std::vector< std::string >& args, std::ostream& output, std::ostream& error_output ){
+		
+		// getopt expects argv, the first element is the program name
+		std::vector< std::string > arg_strings = { "mouse_m908" };
+		arg_strings.insert( arg_strings.end(), args.begin(), args.end() );
+		
+		std::vector< char* > arg_pointers;
+		for( auto& arg : arg_strings )
+			arg_pointers.push_back( arg.data() );
+		arg_pointers.push_back( nullptr );
+		
+		try{
+			
+			cli_options options;
+			int parse_result = parse_options( arg_strings.size(), arg_pointers.data(), options, output );
+			if( parse_result >= 0 )
+				return parse_result;
+			
+			if( options.flag_daemon || options.flag_stream )
+				throw std::string( "--daemon and --stream can not be used in a request." );
+			
+			// the mouse is already open, --bus, --device, --model and --kernel-driver are ignored
+			perform_actions( m, options, output, error_output );
+			
+		} catch( std::string const &message ){
+			
+			error_output << message << "\n";
+			return 1;
+			
+		} catch( std::exception const &e ){
+			
+			error_output << "An exception occured:\n" << e.what() << "\n";
+			return 1;
+			
+		}
+		
+		return 0;
+	} );
+	
+	if( res != 0 )
+		throw std::string( "Couldn't listen on "+daemon_options.string_daemon );
+}
+
+int perform_actions_all( const cli_options &options ){
+	
+	std::vector< rd_mouse::rd_device > devices = rd_mouse::detect_all( options.string_model );
+	
+	if( devices.empty() ){
+		throw std::string( 
+			"Couldn't detect mouse.\n"
+			"- Check hardware and permissions (maybe you need to be root?)\n"
+			"- Try with the --model option\n"
+			"If nothing works please report this as a bug."
+		);
+	}
+	
+	// the result for each mouse, written by its thread
+	struct device_result{
+		int status = 1;
+		double milliseconds = 0;
+		std::stringstream output, error_output;
+	};
+	std::vector< device_result > results( devices.size() );
+	
+	// start one thread per mouse
+	std::vector< std::thread > threads;
+	for( size_t i = 0; i < devices.size(); i++ ){
+		
+		threads.emplace_back( [&options, &device = devices[i], &result = results[i]](){
+			
+			auto start = std::chrono::steady_clock::now();
+			
+			auto open_and_perform_actions = overload(
+				[](rd_mouse::monostate){},
+				[&](auto& m){
+					
+					m.set_detach_kernel_driver( !options.flag_kernel_driver );
+					
+					// open by bus and device to get the right mouse if there are multiple with the same vid and pid
+					open_mouse_wrapper( m, true, true, std::to_string(device.bus), std::to_string(device.device) );
+					
+					try{
+						perform_actions( m, options, result.output, result.error_output );
+					} catch( ... ){ // close mouse, rethrow
+						m.close_mouse();
+						throw;
+					}
+					
+					m.close_mouse();
+					result.status = 0;
+				}
+			);
+			
+			// errors are reported for this mouse only
+			try{
+				std::visit( [&](auto&& arg){ open_and_perform_actions(arg); }, device.mouse );
+			} catch( std::string const &message ){
+				result.error_output << message << "\n";
+			} catch( std::exception const &e ){
+				result.error_output << "An exception occured:\n" << e.what() << "\n";
+			}
+			
+			result.milliseconds = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+		} );
+	}
+	
+	for( auto& thread : threads )
+		thread.join();
+	
+	// print results
+	int status = 0;
+	for( size_t i = 0; i < devices.size(); i++ ){
+		
+		std::string name;
+		std::visit( [&](auto&& m){ name = m.get_name(); }, devices[i].mouse );
+		
+		std::cout << "# " << devices[i].path << " (" << name << "): "
+			<< (results[i].status == 0 ? "ok" : "failed")
+			<< " in " << (int)results[i].milliseconds << " ms\n";
+		std::cout << results[i].output.str();
+		std::cerr << results[i].error_output.str();
+		
+		if( results[i].status != 0 )
+			status = 1;
+	}
+	
+	return status;
+}
+
+void watch_and_apply( const cli_options &options ){
+	
+	// the model is required to prepare the packets, without --model the connected mouse is used
+	rd_mouse::mouse_variant mouse = ( options.string_model == "" ) ? rd_mouse::detect() : rd_mouse::create( options.string_model );
+	
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		throw std::string( 
+			"Couldn't detect mouse.\n"
+			"- Specify the model of the mice to watch for with the --model option\n"
+			"- Check the name of the model (--model ? for a list of valid models)"
+		);
+	}
+	
+	std::string model;
+	std::visit( [&](auto&& m){ model = m.get_name(); }, mouse );
+	
+	// prepare the packets for all actions once, the wireless mice do not support this
+	// and perform the actions on every arrival
+	std::vector< rd_mouse::rd_packet > packets;
+	bool prepared = prepare_packets( mouse, options, packets );
+	
+	std::cout << "Watching for " << model << ", " << packets.size() << " packets prepared.\n";
+	
+	// replug-to-configured latency of all handled arrivals
+	unsigned int count = 0;
+	double latency_sum = 0, latency_min = 0, latency_max = 0;
+	
+	int res = rd_mouse::watch( model, [&]( const rd_mouse::rd_device& device, std::chrono::steady_clock::time_point arrival ){
+		
+		std::visit( overload(
+			[](rd_mouse::monostate){},
+			[&](auto m){
+				
+				int failed = 0;
+				
+				try{
+					m.set_detach_kernel_driver( !options.flag_kernel_driver );
+					open_mouse_wrapper( m, true, true, std::to_string(device.bus), std::to_string(device.device) );
+					
+					try{
+						if( prepared ){
+							set_transfer_options( m, options );
+							m.begin_operation();
+							failed = m.write_packets( packets );
+						} else{
+							perform_actions( m, options, std::cout, std::cerr );
+						}
+					} catch( ... ){
+						m.close_mouse();
+						throw;
+					}
+					
+					m.close_mouse();
+					
+				} catch( std::string const &message ){
+					std::cerr << device.path << ": " << message << "\n";
+					return;
+				} catch( std::exception const &e ){
+					std::cerr << device.path << ": An exception occured:\n" << e.what() << "\n";
+					return;
+				}
+				
+				// latency metric
+				double latency = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - arrival ).count();
+				latency_min = ( count == 0 || latency < latency_min ) ? latency : latency_min;
+				latency_max = ( count == 0 || latency > latency_max ) ? latency : latency_max;
+				latency_sum += latency;
+				count++;
+				
+				std::cout << device.path << " (" << model << "): " << (failed == 0 ? "configured" : "failed")
+					<< ", latency=" << latency << "ms" << (failed != 0 ? ", failed_packets=" + std::to_string(failed) : "") << std::endl;
+			}
+		), device.mouse );
+		
+	} );
+	
+	if( res != 0 )
+		throw std::string( "Couldn't watch for mice, hotplug events are not supported on this system." );
+	
+	// summary
+	if( count > 0 ){
+		std::cout << "Configured " << count << " mice, latency min=" << latency_min
+			<< "ms avg=" << latency_sum / count << "ms max=" << latency_max << "ms\n";
+	}
+}
+
+// set by SIGINT and SIGTERM to end --stream
+volatile std::sig_atomic_t stream_stop = 0;
+void stream_handle_signal( int signal ){
+	(void)signal;
+	stream_stop = 1;
+}
+
+template< typename T > void stream_colors( T &m, const cli_options &options, std::ostream &error_output ){
+	
+	rd_mouse::rd_profile profile = rd_mouse::profile_1;
+	if( options.flag_profile )
+		profile = (rd_mouse::rd_profile)(std::stoi( options.string_profile ) - 1);
+	
+	if( rd_led_stream::prepare( m, profile ) != 0 ){
+		check_transfers( m, "switch the LED to lightmode static" );
+		throw std::string( "Couldn't switch the LED to lightmode static." );
+	}
+	
+	// poll() is interrupted by the signals, reading stdin would be restarted
+	struct sigaction action, old_int, old_term;
+	std::memset( &action, 0, sizeof(action) );
+	action.sa_handler = stream_handle_signal;
+	sigemptyset( &action.sa_mask );
+	sigaction( SIGINT, &action, &old_int );
+	sigaction( SIGTERM, &action, &old_term );
+	
+	// the frames are sent by a second thread, this thread reads the colors
+	rd_led_stream stream( options.stream_rate );
+	std::thread sender( [&](){ stream.run( m, profile ); } );
+	
+	std::string input;
+	char buffer[256];
+	stream_stop = 0;
+	
+	while( !stream_stop ){
+		
+		pollfd descriptor = { STDIN_FILENO, POLLIN, 0 };
+		int ready = poll( &descriptor, 1, -1 );
+		if( ready < 0 && errno != EINTR )
+			break;
+		if( ready <= 0 )
+			continue;
+		
+		ssize_t length = read( STDIN_FILENO, buffer, sizeof(buffer) );
+		if( length <= 0 )
+			break;
+		input.append( buffer, length );
+		
+		// push all complete lines, only the last one is shown if the mouse can not keep up
+		size_t end;
+		while( (end = input.find( '\n' )) != std::string::npos ){
+			
+			std::string line = input.substr( 0, end );
+			input.erase( 0, end+1 );
+			
+			std::array< uint8_t, 3 > color;
+			if( rd_led_stream::parse_color( line, color ) == 0 )
+				stream.push( color );
+			else if( !line.empty() )
+				error_output << "Invalid color, expected rrggbb: " << line << "\n";
+		}
+	}
+	
+	stream.close();
+	sender.join();
+	
+	// restore the previous handlers
+	sigaction( SIGINT, &old_int, NULL );
+	sigaction( SIGTERM, &old_term, NULL );
+	
+	auto stats = stream.get_stats();
+	error_output << "Stream: " << stats.frames << " frames";
+	if( stats.duration > 0 )
+		error_output << " (" << (stats.frames-1) / stats.duration * 1e6 << " per second)";
+	if( stats.frames > 0 )
+		error_output << ", latency " << stats.latency_total / stats.frames / 1000 << " ms average, " << stats.latency_max / 1000 << " ms maximum";
+	error_output << ", " << stats.dropped << " dropped, " << stats.failed << " failed.\n";
+	
+	check_transfers( m, "stream the colors" );
+}
+
+bool prepare_packets( rd_mouse::mouse_variant &mouse, const cli_options &options,
+	std::vector< rd_mouse::rd_packet > &packets ){
+	
+	bool prepared = false;
+	
+	std::visit( overload(
+		[](rd_mouse::monostate){},
+		[&](auto& m){
+			if constexpr( !std::is_base_of_v< rd_mouse_wireless, std::decay_t<decltype(m)> > ){
+				m.set_packet_capture( &packets );
+				perform_actions( m, options, std::cout, std::cerr );
+				m.set_packet_capture( nullptr );
+				prepared = true;
+			}
+		}
+	), mouse );
+	
+	return prepared;
+}
+
+void compile_image( const cli_options &options ){
+	
+	// the model is required to encode the packets, without --model the connected mouse is used
+	rd_mouse::mouse_variant mouse = ( options.string_model == "" ) ? rd_mouse::detect() : rd_mouse::create( options.string_model );
+	
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		throw std::string( 
+			"Couldn't detect mouse.\n"
+			"- Specify the model to compile for with the --model option\n"
+			"- Check the name of the model (--model ? for a list of valid models)"
+		);
+	}
+	
+	std::string model;
+	std::visit( [&](auto&& m){ model = m.get_name(); }, mouse );
+	
+	// the config hash covers the contents of all input files, the options that change the packets
+	// and the version of the program, which determines how the packets are encoded
+	auto read_file = []( const std::string &path ){
+		std::ifstream in( path, std::ios::binary );
+		if( !in.is_open() )
+			throw std::string( "Couldn't open "+path );
+		return std::string( std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() );
+	};
+	
+	std::string inputs = std::string( VERSION_STRING ) + '\0' + model + '\0';
+	inputs += options.flag_config ? "c" + read_file( options.string_config ) + '\0' : "";
+	inputs += options.flag_profile ? "p" + options.string_profile + '\0' : "";
+	inputs += options.flag_macro ? "m" + read_file( options.string_macro ) + '\0' : "";
+	inputs += options.flag_number ? "n" + options.string_number + '\0' : "";
+	inputs += options.flag_dpi ? "d" + options.string_dpi + '\0' : "";
+	uint64_t config_hash = rd_packet_image::hash( inputs );
+	
+	// nothing to do if the image is up to date
+	rd_packet_image existing;
+	if( existing.open( options.string_compile ) == 0 && existing.get_model() == model &&
+		existing.get_config_hash() == config_hash ){
+		std::cout << options.string_compile << " is up to date.\n";
+		return;
+	}
+	existing.close();
+	
+	std::vector< rd_mouse::rd_packet > packets;
+	if( !prepare_packets( mouse, options, packets ) )
+		throw std::string( "Packet images are not supported by this mouse." );
+	
+	if( rd_packet_image::write( options.string_compile, model, config_hash, packets ) != 0 )
+		throw std::string( "Couldn't write "+options.string_compile );
+	
+	std::cout << "Compiled " << packets.size() << " packets for " << model << " to " << options.string_compile << "\n";
+}
+
+void apply_image( const cli_options &options ){
+	
+	rd_packet_image image;
+	int res = image.open( options.string_apply );
+	if( res == 1 )
+		throw std::string( "Couldn't open "+options.string_apply );
+	if( res != 0 )
+		throw std::string( options.string_apply+" is not a valid packet image, compile it again with this version." );
+	
+	if( options.string_model != "" && options.string_model != image.get_model() )
+		throw std::string( options.string_apply+" was compiled for "+image.get_model()+", not "+options.string_model+"." );
+	
+	rd_mouse::mouse_variant mouse = rd_mouse::detect( image.get_model() );
+	
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		throw std::string( 
+			"Couldn't detect mouse.\n"
+			"- "+options.string_apply+" was compiled for "+image.get_model()+"\n"
+			"- Check hardware and permissions (maybe you need to be root?)"
+		);
+	}
+	
+	std::vector< rd_mouse::rd_packet > packets;
+	image.get_packets( packets );
+	image.close();
+	
+	std::visit( overload(
+		[](rd_mouse::monostate){},
+		[&](auto& m){
+			
+			if constexpr( std::is_base_of_v< rd_mouse_wireless, std::decay_t<decltype(m)> > )
+				throw std::string( "Packet images are not supported by this mouse." );
+			
+			m.set_detach_kernel_driver( !options.flag_kernel_driver );
+			open_mouse_wrapper( m, options.flag_bus, options.flag_device, options.string_bus, options.string_device );
+			
+			set_transfer_options( m, options );
+			m.begin_operation();
+			int failed = m.write_packets( packets );
+			
+			m.close_mouse();
+			
+			if( failed != 0 )
+				throw std::string( "Couldn't send "+std::to_string(failed)+" of "+std::to_string(packets.size())+" packets: "+
+					libusb_error_name( m.get_transfer_error() )+"." );
+		}
+	), mouse );
+}
+
+void restore_snapshot( const cli_options &options ){
+	
+	rd_snapshot_file file;
+	int res = file.open( options.string_restore );
+	if( res == 1 )
+		throw std::string( "Couldn't open "+options.string_restore );
+	if( res != 0 )
+		throw std::string( options.string_restore+" is not a valid snapshot, write it again with this version." );
+	
+	if( options.string_model != "" && options.string_model != file.get_model() )
+		throw std::string( options.string_restore+" was read from "+file.get_model()+", not "+options.string_model+"." );
+	
+	rd_mouse::mouse_variant mouse = rd_mouse::detect( file.get_model() );
+	
+	if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		throw std::string( 
+			"Couldn't detect mouse.\n"
+			"- "+options.string_restore+" was read from "+file.get_model()+"\n"
+			"- Check hardware and permissions (maybe you need to be root?)"
+		);
+	}
+	
+	rd_mouse::rd_device_snapshot snapshot;
+	file.get_snapshot( snapshot );
+	uint16_t snapshot_vid = file.get_vid(), snapshot_pid = file.get_pid();
+	file.close();
+	
+	std::visit( overload(
+		[](rd_mouse::monostate){},
+		[&](auto& m){
+			
+			if constexpr( std::is_base_of_v< rd_mouse_wireless, std::decay_t<decltype(m)> > )
+				throw std::string( "Restoring snapshots is not supported by this mouse." );
+			
+			// decode the snapshot and encode the packets before the mouse is opened
+			if( snapshot.parts.empty() || m.read_settings( snapshot ) != 0 )
+				throw std::string( "Restoring snapshots is not supported by this mouse." );
+			
+			std::vector< rd_mouse::rd_packet > packets;
+			m.set_packet_capture( &packets );
+			m.write_settings();
+			for( int i = 1; i < 16; i++ )
+				m.write_macro( i );
+			m.write_profile();
+			m.set_packet_capture( nullptr );
+			
+			m.set_detach_kernel_driver( !options.flag_kernel_driver );
+			open_mouse_wrapper( m, options.flag_bus, options.flag_device, options.string_bus, options.string_device );
+			
+			uint16_t vid = 0, pid = 0;
+			if( m.get_vid_pid( vid, pid ) != 0 || vid != snapshot_vid || pid != snapshot_pid ){
+				m.close_mouse();
+				throw std::string( options.string_restore+" was read from a mouse with different USB ids." );
+			}
+			
+			set_transfer_options( m, options );
+			m.begin_operation();
+			int failed = m.write_packets( packets );
+			
+			m.close_mouse();
+			
+			if( failed != 0 )
+				throw std::string( "Couldn't send "+std::to_string(failed)+" of "+std::to_string(packets.size())+" packets: "+
+					libusb_error_name( m.get_transfer_error() )+"." );
+		}
+	), mouse );
+}
+
 template< typename T >int open_mouse_wrapper( T &m, const bool flag_bus, const bool flag_device,
 	const std::string &string_bus, const std::string &string_device ){
 	